@@ -18,16 +18,33 @@
 #define FB_CORE_MBC_H
 
 #include <util/typedefs.h>
+#include <util/snapshot.h>
 #include <iostream>
 
 namespace FunkyBoy {
 
+    enum class MBCType {
+        None,
+        MBC1,
+        MBC2,
+        MBC3,
+        MBC5
+    };
+
     class MBC {
+    protected:
+        explicit MBC(MBCType type): type(type) {}
+
     public:
+        // Identifies the concrete (final) class, so that hot paths can call it without virtual dispatch
+        const MBCType type;
+
         virtual ~MBC() = default;
 
         virtual u8 readFromROMAt(memory_address offset, u8 *rom) = 0;
         virtual void interceptROMWrite(memory_address offset, u8 val) = 0;
+        // Returns the ROM bank which is currently mapped to the given address (0x0000-0x7FFF)
+        virtual u16 getROMBank(memory_address offset) = 0;
 
         virtual u8 readFromRAMAt(memory_address offset, u8 *ram) = 0;
         virtual bool writeToRAMAt(memory_address offset, u8 val, u8 *ram) = 0;
@@ -38,8 +55,15 @@ namespace FunkyBoy {
         virtual void serialize(std::ostream &ostream) const = 0;
         virtual void deserialize(std::istream &istream) = 0;
 
+        virtual void saveSnapshot(Snapshot::Writer &writer) const = 0;
+        virtual void loadSnapshot(Snapshot::Reader &reader) = 0;
+
         virtual bool hasBattery() = 0;
 
+        // Resets the controller to its power-up state. Battery-backed state, like the real-time clock, is only reset
+        // if it is not kept.
+        virtual void reset(bool keepBatteryState) = 0;
+
         virtual void getDebugInfo(const char **outName, unsigned &outRomBank) = 0;
     };
 
@@ -24,8 +24,6 @@
 
 #define mbc1_print(...) debug_print_4(__VA_ARGS__)
 
-#define FB_MBC1_ROM_BANK_SIZE (16 * 1024)
-
 using namespace FunkyBoy;
 
 size_t MBC1::getRAMBankSize(RAMSize size) {
@@ -89,7 +87,8 @@ u8 MBC1::getROMBankBitMask(ROMSize romSize) {
 }
 
 MBC1::MBC1(ROMSize romSize, RAMSize ramSize, bool battery)
-    : preliminaryRomBank(1)
+    : MBC(MBCType::MBC1)
+    , preliminaryRomBank(1)
     , ramBankSize(getRAMBankSize(ramSize))
     , ramBankCount(getRAMBankCount(ramSize))
     , maxRamOffset(getMaxRAMOffset(ramSize))
@@ -127,22 +126,6 @@ void MBC1::updateBanks() {
     mbc1_print(" [rom=0x%02X,ram=0x%02X]\n", romBank, ramBank);
 }
 
-u8 MBC1::readFromROMAt(memory_address offset, u8 *rom) {
-    if (offset <= 0x3FFF) {
-        if (ramBankingMode) {
-            // TODO: Is this correct? Apparently it should be done like this according to https://gekkio.fi/files/gb-docs/gbctr.pdf
-            return *(rom + romBankOffsetLower + offset);
-        } else {
-            return *(rom + offset);
-        }
-    } else if (offset <= 0x7FFF) {
-        return *(rom + romBankOffset + (offset - 0x4000));
-    } else {
-        // Not readable
-        return 0xff;
-    }
-}
-
 void MBC1::interceptROMWrite(memory_address offset, u8 val) {
     if (offset <= 0x1FFF) {
         ramEnabled = ((val & 0xfu) == 0xA);
@@ -167,22 +150,6 @@ void MBC1::interceptROMWrite(memory_address offset, u8 val) {
     }
 }
 
-u8 MBC1::readFromRAMAt(memory_address offset, u8 *ram) {
-    if (!ramEnabled || offset > maxRamOffset) {
-        // Not readable
-        return 0xff;
-    }
-    return *(ram + ramBankOffset + offset);
-}
-
-bool MBC1::writeToRAMAt(memory_address offset, u8 val, u8 *ram) {
-    if (ramEnabled && offset <= maxRamOffset) {
-        *(ram + ramBankOffset + offset) = val;
-        return true;
-    }
-    return false;
-}
-
 void MBC1::saveBattery(std::ostream &stream, u8 *ram, size_t l) {
     stream.write(reinterpret_cast<char*>(ram), l);
 }
@@ -219,6 +186,36 @@ void MBC1::deserialize(std::istream &istream) {
     ramEnabled = istream.get();
 }
 
+void MBC1::saveSnapshot(Snapshot::Writer &writer) const {
+    writer.write(romBankOffsetLower);
+    writer.write(romBankOffset);
+    writer.write(ramBankOffset);
+    writer.write(preliminaryRomBank);
+    writer.write(romBank);
+    writer.write(ramBank);
+    writer.write(ramBankingMode);
+    writer.write(ramEnabled);
+}
+
+void MBC1::loadSnapshot(Snapshot::Reader &reader) {
+    reader.read(romBankOffsetLower);
+    reader.read(romBankOffset);
+    reader.read(ramBankOffset);
+    reader.read(preliminaryRomBank);
+    reader.read(romBank);
+    reader.read(ramBank);
+    reader.read(ramBankingMode);
+    reader.read(ramEnabled);
+}
+
+void MBC1::reset(bool keepBatteryState) {
+    preliminaryRomBank = 1;
+    ramBank = 0;
+    ramBankingMode = false;
+    ramEnabled = false;
+    updateBanks();
+}
+
 bool MBC1::hasBattery() {
     return battery;
 }
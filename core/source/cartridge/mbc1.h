@@ -23,9 +23,11 @@
 #include <util/ramsizes.h>
 #include <cstddef>
 
+#define FB_MBC1_ROM_BANK_SIZE (16 * 1024)
+
 namespace FunkyBoy {
 
-    class MBC1: public MBC {
+    class MBC1 final : public MBC {
     private:
         const ROMSize romSize;
         const size_t ramBankSize;
@@ -44,11 +46,47 @@ namespace FunkyBoy {
     public:
         MBC1(ROMSize romSize, RAMSize ramSize, bool battery);
 
-        u8 readFromROMAt(memory_address offset, u8 *rom) override;
+        inline u8 readFromROMAt(memory_address offset, u8 *rom) override {
+            if (offset <= 0x3FFF) {
+                if (ramBankingMode) {
+                    // TODO: Is this correct? Apparently it should be done like this according to https://gekkio.fi/files/gb-docs/gbctr.pdf
+                    return *(rom + romBankOffsetLower + offset);
+                } else {
+                    return *(rom + offset);
+                }
+            } else if (offset <= 0x7FFF) {
+                return *(rom + romBankOffset + (offset - 0x4000));
+            } else {
+                // Not readable
+                return 0xff;
+            }
+        }
+
         void interceptROMWrite(memory_address offset, u8 val) override;
 
-        u8 readFromRAMAt(memory_address offset, u8 *ram) override;
-        bool writeToRAMAt(memory_address offset, u8 val, u8 *ram) override;
+        inline u16 getROMBank(memory_address offset) override {
+            if (offset <= 0x3FFF) {
+                return ramBankingMode ? romBankOffsetLower / FB_MBC1_ROM_BANK_SIZE : 0;
+            } else {
+                return romBankOffset / FB_MBC1_ROM_BANK_SIZE;
+            }
+        }
+
+        inline u8 readFromRAMAt(memory_address offset, u8 *ram) override {
+            if (!ramEnabled || offset > maxRamOffset) {
+                // Not readable
+                return 0xff;
+            }
+            return *(ram + ramBankOffset + offset);
+        }
+
+        inline bool writeToRAMAt(memory_address offset, u8 val, u8 *ram) override {
+            if (ramEnabled && offset <= maxRamOffset) {
+                *(ram + ramBankOffset + offset) = val;
+                return true;
+            }
+            return false;
+        }
 
         void saveBattery(std::ostream &stream, u8 *ram, size_t l) override;
         void loadBattery(std::istream &stream, u8 *ram, size_t l) override;
@@ -56,8 +94,13 @@ namespace FunkyBoy {
         void serialize(std::ostream &ostream) const override;
         void deserialize(std::istream &istream) override;
 
+        void saveSnapshot(Snapshot::Writer &writer) const override;
+        void loadSnapshot(Snapshot::Reader &reader) override;
+
         bool hasBattery() override;
 
+        void reset(bool keepBatteryState) override;
+
         void getDebugInfo(const char **outName, unsigned &outRomBank) override;
 
         static size_t getRAMBankSize(RAMSize size);
@@ -22,9 +22,6 @@
 
 #define mbc2_print(...) debug_print_4(__VA_ARGS__)
 
-#define FB_MBC2_ROM_BANK_SIZE (16 * 1024)
-#define FB_MBC2_MAX_RAM_OFFSET (0xA1FF - 0xA000)
-
 using namespace FunkyBoy;
 
 u8 __fb_mbc2_getROMBankBitMask(ROMSize romSize) {
@@ -48,7 +45,8 @@ u8 __fb_mbc2_getROMBankBitMask(ROMSize romSize) {
 }
 
 MBC2::MBC2(ROMSize romSize, bool battery)
-    : romSize(romSize)
+    : MBC(MBCType::MBC2)
+    , romSize(romSize)
     , battery(battery)
     , ramEnabled(false)
     , romBank(1)
@@ -56,17 +54,6 @@ MBC2::MBC2(ROMSize romSize, bool battery)
 {
 }
 
-u8 MBC2::readFromROMAt(memory_address offset, u8 *rom) {
-    if (offset <= 0x3FFF) {
-        return *(rom + offset);
-    } else if (offset <= 0x7FFF) {
-        return *(rom + romBankOffset + (offset - 0x4000));
-    } else {
-        // Not readable
-        return 0xff;
-    }
-}
-
 void MBC2::interceptROMWrite(memory_address offset, u8 val) {
     if (offset <= 0x1FFF) {
         if (!(offset & 0x0100u)) {
@@ -85,24 +72,6 @@ void MBC2::interceptROMWrite(memory_address offset, u8 val) {
     }
 }
 
-u8 MBC2::readFromRAMAt(memory_address offset, u8 *ram) {
-    if (!ramEnabled) {
-        // Not readable
-        return 0xff;
-    }
-    // When going higher than 0xA1FF, the RAM just wraps around (i.e. starts reading again from 0xA000)
-    return (*(ram + (offset % (FB_MBC2_MAX_RAM_OFFSET + 1))) & 0b1111u) | 0b11110000u;
-}
-
-bool MBC2::writeToRAMAt(memory_address offset, u8 val, u8 *ram) {
-    if (ramEnabled) {
-        // When going higher than 0xA1FF, the RAM just wraps around (i.e. starts writing again to 0xA000)
-        *(ram + (offset % (FB_MBC2_MAX_RAM_OFFSET + 1))) = val & 0b1111u;
-        return true;
-    }
-    return false;
-}
-
 void MBC2::saveBattery(std::ostream &stream, u8 *ram, size_t l) {
     stream.write(reinterpret_cast<char*>(ram), l);
 }
@@ -129,6 +98,24 @@ void MBC2::deserialize(std::istream &istream) {
     ramEnabled = istream.get();
 }
 
+void MBC2::saveSnapshot(Snapshot::Writer &writer) const {
+    writer.write(romBankOffset);
+    writer.write(romBank);
+    writer.write(ramEnabled);
+}
+
+void MBC2::loadSnapshot(Snapshot::Reader &reader) {
+    reader.read(romBankOffset);
+    reader.read(romBank);
+    reader.read(ramEnabled);
+}
+
+void MBC2::reset(bool keepBatteryState) {
+    romBank = 1;
+    romBankOffset = 1 * FB_MBC2_ROM_BANK_SIZE;
+    ramEnabled = false;
+}
+
 bool MBC2::hasBattery() {
     return battery;
 }
@@ -21,9 +21,12 @@
 #include <util/testing.h>
 #include <util/romsizes.h>
 
+#define FB_MBC2_ROM_BANK_SIZE (16 * 1024)
+#define FB_MBC2_MAX_RAM_OFFSET (0xA1FF - 0xA000)
+
 namespace FunkyBoy {
 
-    class MBC2: public MBC {
+    class MBC2 final : public MBC {
     private:
         const ROMSize romSize;
         const bool battery;
@@ -34,11 +37,40 @@ namespace FunkyBoy {
     public:
         MBC2(ROMSize romSize, bool battery);
 
-        u8 readFromROMAt(memory_address offset, u8 *rom) override;
+        inline u8 readFromROMAt(memory_address offset, u8 *rom) override {
+            if (offset <= 0x3FFF) {
+                return *(rom + offset);
+            } else if (offset <= 0x7FFF) {
+                return *(rom + romBankOffset + (offset - 0x4000));
+            } else {
+                // Not readable
+                return 0xff;
+            }
+        }
+
         void interceptROMWrite(memory_address offset, u8 val) override;
 
-        u8 readFromRAMAt(memory_address offset, u8 *ram) override;
-        bool writeToRAMAt(memory_address offset, u8 val, u8 *ram) override;
+        inline u16 getROMBank(memory_address offset) override {
+            return offset <= 0x3FFF ? 0 : romBankOffset / FB_MBC2_ROM_BANK_SIZE;
+        }
+
+        inline u8 readFromRAMAt(memory_address offset, u8 *ram) override {
+            if (!ramEnabled) {
+                // Not readable
+                return 0xff;
+            }
+            // When going higher than 0xA1FF, the RAM just wraps around (i.e. starts reading again from 0xA000)
+            return (*(ram + (offset % (FB_MBC2_MAX_RAM_OFFSET + 1))) & 0b1111u) | 0b11110000u;
+        }
+
+        inline bool writeToRAMAt(memory_address offset, u8 val, u8 *ram) override {
+            if (ramEnabled) {
+                // When going higher than 0xA1FF, the RAM just wraps around (i.e. starts writing again to 0xA000)
+                *(ram + (offset % (FB_MBC2_MAX_RAM_OFFSET + 1))) = val & 0b1111u;
+                return true;
+            }
+            return false;
+        }
 
         void saveBattery(std::ostream &stream, u8 *ram, size_t l) override;
         void loadBattery(std::istream &stream, u8 *ram, size_t l) override;
@@ -46,8 +78,13 @@ namespace FunkyBoy {
         void serialize(std::ostream &ostream) const override;
         void deserialize(std::istream &istream) override;
 
+        void saveSnapshot(Snapshot::Writer &writer) const override;
+        void loadSnapshot(Snapshot::Reader &reader) override;
+
         bool hasBattery() override;
 
+        void reset(bool keepBatteryState) override;
+
         void getDebugInfo(const char **outName, unsigned &outRomBank) override;
     };
 
@@ -25,8 +25,6 @@
 
 #define mbc3_print(...) debug_print_4(__VA_ARGS__)
 
-#define FB_MBC3_ROM_BANK_SIZE (16 * 1024)
-
 using namespace FunkyBoy;
 
 size_t MBC3::getRAMBankSize(RAMSize size) {
@@ -76,7 +74,8 @@ memory_address MBC3::getMaxRAMOffset(RAMSize ramSize) {
 }
 
 MBC3::MBC3(ROMSize romSize, RAMSize ramSize, bool battery, bool rtc, bool mbc30)
-    : preliminaryRomBank(1)
+    : MBC(MBCType::MBC3)
+    , preliminaryRomBank(1)
     , ramBankSize(getRAMBankSize(ramSize))
     , ramBankCount(getRAMBankCount(ramSize))
     , maxRamOffset(getMaxRAMOffset(ramSize))
@@ -112,17 +111,6 @@ void MBC3::updateBanks() {
     mbc3_print(" [rom=0x%02X,ram=0x%02X]\n", romBank, ramBank);
 }
 
-u8 MBC3::readFromROMAt(memory_address offset, u8 *rom) {
-    if (offset <= 0x3FFF) {
-        return *(rom + offset);
-    } else if (offset <= 0x7FFF) {
-        return *(rom + romBankOffset + (offset - 0x4000));
-    } else {
-        // Not readable
-        return 0xff;
-    }
-}
-
 void MBC3::interceptROMWrite(memory_address offset, u8 val) {
     if (offset <= 0x1FFF) {
         ramEnabled = ((val & 0xfu) == 0xA);
@@ -286,6 +274,40 @@ void MBC3::deserialize(std::istream &istream) {
     rtc.deserialize(istream);
 }
 
+void MBC3::saveSnapshot(Snapshot::Writer &writer) const {
+    writer.write(romBankOffsetLower);
+    writer.write(romBankOffset);
+    writer.write(ramBankOffset);
+    writer.write(preliminaryRomBank);
+    writer.write(romBank);
+    writer.write(ramBank);
+    writer.write(ramEnabled);
+
+    rtc.saveSnapshot(writer);
+}
+
+void MBC3::loadSnapshot(Snapshot::Reader &reader) {
+    reader.read(romBankOffsetLower);
+    reader.read(romBankOffset);
+    reader.read(ramBankOffset);
+    reader.read(preliminaryRomBank);
+    reader.read(romBank);
+    reader.read(ramBank);
+    reader.read(ramEnabled);
+
+    rtc.loadSnapshot(reader);
+}
+
+void MBC3::reset(bool keepBatteryState) {
+    preliminaryRomBank = 1;
+    ramBank = 0;
+    ramEnabled = false;
+    updateBanks();
+    if (!keepBatteryState) {
+        rtc.reset();
+    }
+}
+
 bool MBC3::hasBattery() {
     return useBattery;
 }
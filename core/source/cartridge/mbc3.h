@@ -24,9 +24,11 @@
 #include <util/ramsizes.h>
 #include <cstddef>
 
+#define FB_MBC3_ROM_BANK_SIZE (16 * 1024)
+
 namespace FunkyBoy {
 
-    class MBC3: public MBC {
+    class MBC3 final : public MBC {
     private:
         const ROMSize romSize;
         const size_t ramBankSize;
@@ -48,9 +50,23 @@ namespace FunkyBoy {
     public:
         MBC3(ROMSize romSize, RAMSize ramSize, bool battery, bool rtc, bool mbc30);
 
-        u8 readFromROMAt(memory_address offset, u8 *rom) override;
+        inline u8 readFromROMAt(memory_address offset, u8 *rom) override {
+            if (offset <= 0x3FFF) {
+                return *(rom + offset);
+            } else if (offset <= 0x7FFF) {
+                return *(rom + romBankOffset + (offset - 0x4000));
+            } else {
+                // Not readable
+                return 0xff;
+            }
+        }
+
         void interceptROMWrite(memory_address offset, u8 val) override;
 
+        inline u16 getROMBank(memory_address offset) override {
+            return offset <= 0x3FFF ? 0 : romBankOffset / FB_MBC3_ROM_BANK_SIZE;
+        }
+
         u8 readFromRAMAt(memory_address offset, u8 *ram) override;
         bool writeToRAMAt(memory_address offset, u8 val, u8 *ram) override;
 
@@ -60,8 +76,13 @@ namespace FunkyBoy {
         void serialize(std::ostream &ostream) const override;
         void deserialize(std::istream &istream) override;
 
+        void saveSnapshot(Snapshot::Writer &writer) const override;
+        void loadSnapshot(Snapshot::Reader &reader) override;
+
         bool hasBattery() override;
 
+        void reset(bool keepBatteryState) override;
+
         void getDebugInfo(const char **outName, unsigned &outRomBank) override;
 
         static size_t getRAMBankSize(RAMSize size);
@@ -24,8 +24,6 @@
 
 #define mbc5_print(...) debug_print_4(__VA_ARGS__)
 
-#define FB_MBC5_ROM_BANK_SIZE (16 * 1024)
-
 using namespace FunkyBoy;
 
 u16_fast MBC5::getROMBankBitMask(ROMSize romSize) {
@@ -56,7 +54,8 @@ u16_fast MBC5::getROMBankBitMask(ROMSize romSize) {
 }
 
 MBC5::MBC5(ROMSize romSize, RAMSize ramSize, bool battery)
-    : preliminaryRomBank(1)
+    : MBC(MBCType::MBC5)
+    , preliminaryRomBank(1)
     , ramBankSize(MBC1::getRAMBankSize(ramSize))
     , ramBankCount(MBC1::getRAMBankCount(ramSize))
     , maxRamOffset(MBC1::getMaxRAMOffset(ramSize))
@@ -83,17 +82,6 @@ void MBC5::updateBanks() {
     mbc5_print(" [rom=0x%02X,ram=0x%02X]\n", romBank, ramBank);
 }
 
-u8 MBC5::readFromROMAt(memory_address offset, u8 *rom) {
-    if (offset <= 0x3FFF) {
-        return *(rom + offset);
-    } else if (offset <= 0x7FFF) {
-        return *(rom + romBankOffset + (offset - 0x4000));
-    } else {
-        // Not readable
-        return 0xff;
-    }
-}
-
 void MBC5::interceptROMWrite(memory_address offset, u8 val) {
     if (offset <= 0x1FFF) {
         ramEnabled = (val & 0xfu) == 0xA;
@@ -116,22 +104,6 @@ void MBC5::interceptROMWrite(memory_address offset, u8 val) {
     }
 }
 
-u8 MBC5::readFromRAMAt(memory_address offset, u8 *ram) {
-    if (!ramEnabled || offset > maxRamOffset) {
-        // Not readable
-        return 0xff;
-    }
-    return *(ram + ramBankOffset + offset);
-}
-
-bool MBC5::writeToRAMAt(memory_address offset, u8 val, u8 *ram) {
-    if (ramEnabled && offset <= maxRamOffset) {
-        *(ram + ramBankOffset + offset) = val;
-        return true;
-    }
-    return false;
-}
-
 void MBC5::saveBattery(std::ostream &stream, u8 *ram, size_t l) {
     stream.write(reinterpret_cast<char*>(ram), l);
 }
@@ -168,6 +140,31 @@ void MBC5::deserialize(std::istream &istream) {
     ramEnabled = istream.get();
 }
 
+void MBC5::saveSnapshot(Snapshot::Writer &writer) const {
+    writer.write(romBankOffset);
+    writer.write(ramBankOffset);
+    writer.write(preliminaryRomBank);
+    writer.write(romBank);
+    writer.write(ramBank);
+    writer.write(ramEnabled);
+}
+
+void MBC5::loadSnapshot(Snapshot::Reader &reader) {
+    reader.read(romBankOffset);
+    reader.read(ramBankOffset);
+    reader.read(preliminaryRomBank);
+    reader.read(romBank);
+    reader.read(ramBank);
+    reader.read(ramEnabled);
+}
+
+void MBC5::reset(bool keepBatteryState) {
+    preliminaryRomBank = 1;
+    ramBank = 0;
+    ramEnabled = false;
+    updateBanks();
+}
+
 bool MBC5::hasBattery() {
     return battery;
 }
@@ -23,9 +23,11 @@
 #include <util/ramsizes.h>
 #include <cstddef>
 
+#define FB_MBC5_ROM_BANK_SIZE (16 * 1024)
+
 namespace FunkyBoy {
 
-    class MBC5: public MBC {
+    class MBC5 final : public MBC {
     private:
         const ROMSize romSize;
         const size_t ramBankSize;
@@ -42,11 +44,38 @@ namespace FunkyBoy {
     public:
         MBC5(ROMSize romSize, RAMSize ramSize, bool battery);
 
-        u8 readFromROMAt(memory_address offset, u8 *rom) override;
+        inline u8 readFromROMAt(memory_address offset, u8 *rom) override {
+            if (offset <= 0x3FFF) {
+                return *(rom + offset);
+            } else if (offset <= 0x7FFF) {
+                return *(rom + romBankOffset + (offset - 0x4000));
+            } else {
+                // Not readable
+                return 0xff;
+            }
+        }
+
         void interceptROMWrite(memory_address offset, u8 val) override;
 
-        u8 readFromRAMAt(memory_address offset, u8 *ram) override;
-        bool writeToRAMAt(memory_address offset, u8 val, u8 *ram) override;
+        inline u16 getROMBank(memory_address offset) override {
+            return offset <= 0x3FFF ? 0 : romBankOffset / FB_MBC5_ROM_BANK_SIZE;
+        }
+
+        inline u8 readFromRAMAt(memory_address offset, u8 *ram) override {
+            if (!ramEnabled || offset > maxRamOffset) {
+                // Not readable
+                return 0xff;
+            }
+            return *(ram + ramBankOffset + offset);
+        }
+
+        inline bool writeToRAMAt(memory_address offset, u8 val, u8 *ram) override {
+            if (ramEnabled && offset <= maxRamOffset) {
+                *(ram + ramBankOffset + offset) = val;
+                return true;
+            }
+            return false;
+        }
 
         void saveBattery(std::ostream &stream, u8 *ram, size_t l) override;
         void loadBattery(std::istream &stream, u8 *ram, size_t l) override;
@@ -54,8 +83,13 @@ namespace FunkyBoy {
         void serialize(std::ostream &ostream) const override;
         void deserialize(std::istream &istream) override;
 
+        void saveSnapshot(Snapshot::Writer &writer) const override;
+        void loadSnapshot(Snapshot::Reader &reader) override;
+
         bool hasBattery() override;
 
+        void reset(bool keepBatteryState) override;
+
         void getDebugInfo(const char **outName, unsigned &outRomBank) override;
 
         static u16_fast getROMBankBitMask(ROMSize romSize);
@@ -18,36 +18,35 @@
 
 using namespace FunkyBoy;
 
-u8 MBCNone::readFromROMAt(memory_address offset, u8 *rom) {
-    return *(rom + offset);
+void MBCNone::interceptROMWrite(memory_address, FunkyBoy::u8) {
+    // Do nothing
 }
 
-void MBCNone::interceptROMWrite(memory_address, FunkyBoy::u8) {
+void MBCNone::saveBattery(std::ostream &stream, u8 *ram, size_t l) {
     // Do nothing
 }
 
-u8 MBCNone::readFromRAMAt(memory_address offset, u8 *ram) {
-    return *(ram + offset);
+void MBCNone::loadBattery(std::istream &stream, u8 *ram, size_t l) {
+    // Do nothing
 }
 
-bool MBCNone::writeToRAMAt(memory_address offset, u8 val, u8 *ram) {
-    *(ram + offset) = val;
-    return true;
+void MBCNone::serialize(std::ostream &ostream) const {
+    // Do nothing
 }
 
-void MBCNone::saveBattery(std::ostream &stream, u8 *ram, size_t l) {
+void MBCNone::deserialize(std::istream &istream) {
     // Do nothing
 }
 
-void MBCNone::loadBattery(std::istream &stream, u8 *ram, size_t l) {
+void MBCNone::saveSnapshot(Snapshot::Writer &writer) const {
     // Do nothing
 }
 
-void MBCNone::serialize(std::ostream &ostream) const {
+void MBCNone::loadSnapshot(Snapshot::Reader &reader) {
     // Do nothing
 }
 
-void MBCNone::deserialize(std::istream &istream) {
+void MBCNone::reset(bool keepBatteryState) {
     // Do nothing
 }
 
@@ -21,13 +21,28 @@
 
 namespace FunkyBoy {
 
-    class MBCNone: public MBC {
+    class MBCNone final : public MBC {
     public:
-        u8 readFromROMAt(memory_address offset, u8 *rom) override;
+        MBCNone(): MBC(MBCType::None) {}
+
+        inline u8 readFromROMAt(memory_address offset, u8 *rom) override {
+            return *(rom + offset);
+        }
+
         void interceptROMWrite(memory_address offset, u8 val) override;
 
-        u8 readFromRAMAt(memory_address offset, u8 *ram) override;
-        bool writeToRAMAt(memory_address offset, u8 val, u8 *ram) override;
+        inline u16 getROMBank(memory_address offset) override {
+            return offset <= 0x3FFF ? 0 : 1;
+        }
+
+        inline u8 readFromRAMAt(memory_address offset, u8 *ram) override {
+            return *(ram + offset);
+        }
+
+        inline bool writeToRAMAt(memory_address offset, u8 val, u8 *ram) override {
+            *(ram + offset) = val;
+            return true;
+        }
 
         void saveBattery(std::ostream &stream, u8 *ram, size_t l) override;
         void loadBattery(std::istream &stream, u8 *ram, size_t l) override;
@@ -35,8 +50,13 @@ namespace FunkyBoy {
         void serialize(std::ostream &ostream) const override;
         void deserialize(std::istream &istream) override;
 
+        void saveSnapshot(Snapshot::Writer &writer) const override;
+        void loadSnapshot(Snapshot::Reader &reader) override;
+
         bool hasBattery() override;
 
+        void reset(bool keepBatteryState) override;
+
         void getDebugInfo(const char **outName, unsigned &outRomBank) override;
     };
 
@@ -0,0 +1,102 @@
+/**
+ * Copyright 2021 Michel Kremer (kremi151)
+ *
+ * Licensed under the Apache License, Version 2.0 (the License);
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "rom_image.h"
+
+#include <util/romsizes.h>
+#include <fstream>
+#include <system_error>
+
+#if HAS_POSIX_MMAP
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using namespace FunkyBoy;
+
+ROMImage::ROMImage()
+    : mapping(nullptr)
+    , data(nullptr)
+    , size(0)
+{
+}
+
+ROMImage::~ROMImage() {
+#if HAS_POSIX_MMAP
+    if (mapping != nullptr) {
+        munmap(mapping, size);
+    }
+#endif
+}
+
+ROMImagePtr ROMImage::fromBuffer(std::unique_ptr<u8[]> buffer, size_t size) {
+    std::shared_ptr<ROMImage> image(new ROMImage());
+    image->data = buffer.get();
+    image->size = size;
+    image->buffer = std::move(buffer);
+    return image;
+}
+
+ROMImagePtr ROMImage::fromStream(std::istream &stream) {
+    if (!stream.good()) {
+        return nullptr;
+    }
+    stream.seekg(0, std::ios::end);
+    size_t length = stream.tellg();
+    stream.seekg(0, std::ios::beg);
+
+    std::unique_ptr<u8[]> buffer(new u8[length]);
+    stream.read(reinterpret_cast<char*>(buffer.get()), length);
+    if (static_cast<size_t>(stream.gcount()) != length) {
+        return nullptr;
+    }
+    return fromBuffer(std::move(buffer), length);
+}
+
+ROMImagePtr ROMImage::fromFile(const fs::path &path) {
+#if HAS_POSIX_MMAP
+    // Opening a FIFO would otherwise block until it is written to
+    int fd = open(path.c_str(), O_RDONLY | O_NONBLOCK);
+    if (fd >= 0) {
+        struct stat fileStat{};
+        void *mapping = MAP_FAILED;
+        if (fstat(fd, &fileStat) == 0 && S_ISREG(fileStat.st_mode) && fileStat.st_size > 0) {
+            mapping = mmap(nullptr, fileStat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        }
+        // The mapping stays valid after the file descriptor has been closed
+        close(fd);
+        if (mapping != MAP_FAILED) {
+            std::shared_ptr<ROMImage> image(new ROMImage());
+            image->mapping = mapping;
+            image->data = static_cast<const u8*>(mapping);
+            image->size = fileStat.st_size;
+            return image;
+        }
+    }
+#endif
+    // The file is only read if it can be a ROM at all, so that FIFOs or oversized files are not buffered in full
+    std::error_code error;
+    if (!fs::is_regular_file(path, error)
+        || fs::file_size(path, error) > romSizeInBytes(ROMSize::ROM_SIZE_8M)
+        || error) {
+        return nullptr;
+    }
+    std::ifstream file(path.c_str(), std::ios::binary | std::ios::in);
+    return fromStream(file);
+}
@@ -0,0 +1,73 @@
+/**
+ * Copyright 2021 Michel Kremer (kremi151)
+ *
+ * Licensed under the Apache License, Version 2.0 (the License);
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef FB_CORE_ROM_IMAGE_H
+#define FB_CORE_ROM_IMAGE_H
+
+#include <util/typedefs.h>
+#include <util/fs.h>
+#include <memory>
+#include <iostream>
+
+namespace FunkyBoy {
+
+    class ROMImage;
+
+    typedef std::shared_ptr<const ROMImage> ROMImagePtr;
+
+    /**
+     * Read-only ROM contents, which can be shared by any number of emulators. The image is either backed by a buffer
+     * or by a memory mapping of the ROM file.
+     */
+    class ROMImage {
+    private:
+        std::unique_ptr<u8[]> buffer;
+        void *mapping;
+        const u8 *data;
+        size_t size;
+
+        ROMImage();
+    public:
+        ~ROMImage();
+
+        ROMImage(const ROMImage &other) = delete;
+        ROMImage &operator= (const ROMImage &other) = delete;
+
+        // Takes ownership of the given buffer
+        static ROMImagePtr fromBuffer(std::unique_ptr<u8[]> buffer, size_t size);
+        // Reads the whole stream into a buffer, or returns nullptr if it is not readable
+        static ROMImagePtr fromStream(std::istream &stream);
+        // Maps the file into memory if the platform supports it and reads it otherwise. Returns nullptr if the file is
+        // not readable, or if it has to be read and is not a regular file of at most the maximal ROM size.
+        static ROMImagePtr fromFile(const fs::path &path);
+
+        inline const u8 *getData() const {
+            return data;
+        }
+
+        inline size_t getSize() const {
+            return size;
+        }
+
+        inline bool isMapped() const {
+            return mapping != nullptr;
+        }
+    };
+
+}
+
+#endif //FB_CORE_ROM_IMAGE_H
@@ -69,6 +69,17 @@ RTC::RTC()
 {
 }
 
+void RTC::reset() {
+    haltedDays = 0;
+    haltedHours = 0;
+    haltedMinutes = 0;
+    haltedSeconds = 0;
+    latchTimestamp = 0;
+    startTimestamp = get_time();
+    timestampOffset = 0;
+    halted = false;
+}
+
 u8 RTC::getSeconds() {
     if (halted) {
         return haltedSeconds;
@@ -237,4 +248,26 @@ void RTC::deserialize(std::istream &istream) {
     haltedMinutes = istream.get();
     haltedSeconds = istream.get();
     halted = istream.get();
+}
+
+void RTC::saveSnapshot(Snapshot::Writer &writer) const {
+    writer.write(startTimestamp);
+    writer.write(timestampOffset);
+    writer.write(latchTimestamp);
+    writer.write(haltedDays);
+    writer.write(haltedHours);
+    writer.write(haltedMinutes);
+    writer.write(haltedSeconds);
+    writer.write(halted);
+}
+
+void RTC::loadSnapshot(Snapshot::Reader &reader) {
+    reader.read(startTimestamp);
+    reader.read(timestampOffset);
+    reader.read(latchTimestamp);
+    reader.read(haltedDays);
+    reader.read(haltedHours);
+    reader.read(haltedMinutes);
+    reader.read(haltedSeconds);
+    reader.read(halted);
 }
\ No newline at end of file
@@ -18,6 +18,7 @@
 #define FB_CORE_CARTRIDGE_RTC_H
 
 #include <util/typedefs.h>
+#include <util/snapshot.h>
 #include <ctime>
 #include <memory>
 #include <iostream>
@@ -47,6 +48,9 @@ namespace FunkyBoy {
     public:
         RTC();
 
+        // Starts counting from zero again, as if the cartridge had just been manufactured
+        void reset();
+
         u8 getSeconds();
         u8 getMinutes();
         u8 getHours();
@@ -68,6 +72,9 @@ namespace FunkyBoy {
         void serialize(std::ostream &ostream) const;
         void deserialize(std::istream &istream);
 
+        void saveSnapshot(Snapshot::Writer &writer) const;
+        void loadSnapshot(Snapshot::Reader &reader);
+
 #ifdef FB_TESTING
         inline bool isHalted() const {
             return halted;
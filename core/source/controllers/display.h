@@ -18,6 +18,7 @@
 #define FB_CORE_CONTROLLERS_DISPLAY_H
 
 #include <memory>
+#include <emulator/frame_buffer.h>
 #include <util/typedefs.h>
 
 namespace FunkyBoy::Controller {
@@ -26,8 +27,8 @@ namespace FunkyBoy::Controller {
     public:
         virtual ~DisplayController() = default;
 
-        virtual void drawScanLine(u8 y, u8 *buffer) = 0;
-        virtual void drawScreen() = 0;
+        // Called once per frame which has been drawn, the frame buffer remains unchanged until the call returns
+        virtual void drawScreen(const FrameBuffer &frameBuffer) = 0;
     };
 
     typedef std::shared_ptr<DisplayController> DisplayControllerPtr;
@@ -18,10 +18,6 @@
 
 using namespace FunkyBoy::Controller;
 
-void DisplayControllerVoid::drawScanLine(FunkyBoy::u8 y, FunkyBoy::u8 *buffer) {
-    // Do nothing
-}
-
-void DisplayControllerVoid::drawScreen() {
+void DisplayControllerVoid::drawScreen(const FunkyBoy::FrameBuffer &frameBuffer) {
     // Do nothing
 }
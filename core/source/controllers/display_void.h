@@ -23,8 +23,7 @@ namespace FunkyBoy::Controller {
 
     class DisplayControllerVoid: public DisplayController {
     public:
-        void drawScanLine(u8 y, u8 *buffer) override;
-        void drawScreen() override;
+        void drawScreen(const FrameBuffer &frameBuffer) override;
     };
 
 }
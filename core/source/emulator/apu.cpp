@@ -98,8 +98,28 @@ void APU::doTick() {
     if (!apuEnabled) {
         return;
     }
-    u16_fast sysCounter = ioRegisters.getSysCounter();
+    doTick(ioRegisters.getSysCounter());
+}
+
+void APU::doTicks(u32_fast ticks) {
+    if (!apuEnabled || ticks == 0) {
+        return;
+    }
+    // The timers have already been advanced past all of these ticks, so we reconstruct the system counter
+    // value of each tick
+    u16 sysCounter = ioRegisters.getSysCounter() - (ticks - 1) * 4;
+    while (ticks-- > 0) {
+        doTick(sysCounter);
+        sysCounter += 4;
+    }
+}
+
+FunkyBoy::u32_fast APU::getTicksUntilFrameSequencerStep() {
+    // The system counter is advanced by 4 clocks before each tick
+    return (frameSeqMod - ioRegisters.getSysCounter() % frameSeqMod) / 4;
+}
 
+void APU::doTick(u16_fast sysCounter) {
     tickChannel1Or2(channelOne, ioRegisters.getNR13(), ioRegisters.getNR14());
     tickChannel1Or2(channelTwo, ioRegisters.getNR23(), ioRegisters.getNR24());
     tickChannel3();
@@ -490,4 +510,24 @@ void APU::deserialize(std::istream &istream) {
     apuEnabled = istream.get();
 }
 
+void APU::saveSnapshot(Snapshot::Writer &writer) const {
+    channelOne.saveSnapshot(writer);
+    channelTwo.saveSnapshot(writer);
+    channelThree.saveSnapshot(writer);
+    channelFour.saveSnapshot(writer);
+
+    writer.write(frameSeqStep);
+    writer.write(apuEnabled);
+}
+
+void APU::loadSnapshot(Snapshot::Reader &reader) {
+    channelOne.loadSnapshot(reader);
+    channelTwo.loadSnapshot(reader);
+    channelThree.loadSnapshot(reader);
+    channelFour.loadSnapshot(reader);
+
+    reader.read(frameSeqStep);
+    reader.read(apuEnabled);
+}
+
 #endif
@@ -23,6 +23,7 @@
 #include <iostream>
 #include <util/typedefs.h>
 #include <util/configurable.h>
+#include <util/snapshot.h>
 #include <emulator/io_registers.h>
 #include <emulator/gb_type.h>
 #include <emulator/audio/channel_one.h>
@@ -66,6 +67,7 @@ namespace FunkyBoy::Sound {
         static void doLength(u8_fast nrx4, BaseChannel &channel);
 
         static void tickChannel1Or2(ToneChannel &channel, u8_fast nrx3, u8_fast nrx4);
+        void doTick(u16_fast sysCounter);
         void tickChannel3();
         void tickChannel4();
 
@@ -104,12 +106,19 @@ namespace FunkyBoy::Sound {
         void onControllersUpdated(const Controller::Controllers &controllers) override;
 
         void doTick();
+        // Performs the given number of ticks, which have to lag behind the timers
+        void doTicks(u32_fast ticks);
+        // Returns the number of ticks until the next step of the frame sequencer
+        u32_fast getTicksUntilFrameSequencerStep();
 
         void handleWrite(memory_address addr, u8_fast value);
 
         void serialize(std::ostream &ostream) const;
         void deserialize(std::istream &istream);
 
+        void saveSnapshot(Snapshot::Writer &writer) const;
+        void loadSnapshot(Snapshot::Reader &reader);
+
         friend Memory;
     };
 
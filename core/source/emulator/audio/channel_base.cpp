@@ -33,3 +33,17 @@ void BaseChannelType::deserialize(std::istream &stream) {
     freqTimer = Util::Stream::read16Bits(stream);
     dacEnabled = stream.get();
 }
+
+void BaseChannelType::saveSnapshot(Snapshot::Writer &writer) const {
+    writer.write(channelEnabled);
+    writer.write(lengthTimer);
+    writer.write(freqTimer);
+    writer.write(dacEnabled);
+}
+
+void BaseChannelType::loadSnapshot(Snapshot::Reader &reader) {
+    reader.read(channelEnabled);
+    reader.read(lengthTimer);
+    reader.read(freqTimer);
+    reader.read(dacEnabled);
+}
@@ -19,6 +19,7 @@
 
 #include <iostream>
 #include <util/typedefs.h>
+#include <util/snapshot.h>
 
 namespace FunkyBoy::Sound {
 
@@ -32,6 +33,9 @@ namespace FunkyBoy::Sound {
 
         virtual void serialize(std::ostream &stream) const;
         virtual void deserialize(std::istream &stream);
+
+        virtual void saveSnapshot(Snapshot::Writer &writer) const;
+        virtual void loadSnapshot(Snapshot::Reader &reader);
     } BaseChannel;
 
 }
@@ -31,3 +31,17 @@ void EnvelopeChannelType::deserialize(std::istream &stream) {
     periodTimer = stream.get();
     currentVolume = stream.get();
 }
+
+void EnvelopeChannelType::saveSnapshot(Snapshot::Writer &writer) const {
+    BaseChannelType::saveSnapshot(writer);
+
+    writer.write(periodTimer);
+    writer.write(currentVolume);
+}
+
+void EnvelopeChannelType::loadSnapshot(Snapshot::Reader &reader) {
+    BaseChannelType::loadSnapshot(reader);
+
+    reader.read(periodTimer);
+    reader.read(currentVolume);
+}
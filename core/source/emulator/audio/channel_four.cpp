@@ -31,3 +31,15 @@ void ChannelFourType::deserialize(std::istream &stream) {
 
     lfsr = Util::Stream::read16Bits(stream);
 }
+
+void ChannelFourType::saveSnapshot(Snapshot::Writer &writer) const {
+    EnvelopeChannelType::saveSnapshot(writer);
+
+    writer.write(lfsr);
+}
+
+void ChannelFourType::loadSnapshot(Snapshot::Reader &reader) {
+    EnvelopeChannelType::loadSnapshot(reader);
+
+    reader.read(lfsr);
+}
@@ -26,6 +26,9 @@ namespace FunkyBoy::Sound {
 
         void serialize(std::ostream &stream) const override;
         void deserialize(std::istream &stream) override;
+
+        void saveSnapshot(Snapshot::Writer &writer) const override;
+        void loadSnapshot(Snapshot::Reader &reader) override;
     } ChannelFour;
 
 }
@@ -33,3 +33,19 @@ void ChannelOneType::deserialize(std::istream &stream) {
     sweepTimer = stream.get();
     shadowFrequency = stream.get();
 }
+
+void ChannelOneType::saveSnapshot(Snapshot::Writer &writer) const {
+    ToneChannelType::saveSnapshot(writer);
+
+    writer.write(sweepEnabled);
+    writer.write(sweepTimer);
+    writer.write(shadowFrequency);
+}
+
+void ChannelOneType::loadSnapshot(Snapshot::Reader &reader) {
+    ToneChannelType::loadSnapshot(reader);
+
+    reader.read(sweepEnabled);
+    reader.read(sweepTimer);
+    reader.read(shadowFrequency);
+}
@@ -27,3 +27,13 @@ void ChannelThreeType::deserialize(std::istream &stream) {
     BaseChannelType::deserialize(stream);
     WaveChannelType::deserialize(stream);
 }
+
+void ChannelThreeType::saveSnapshot(Snapshot::Writer &writer) const {
+    BaseChannelType::saveSnapshot(writer);
+    WaveChannelType::saveSnapshot(writer);
+}
+
+void ChannelThreeType::loadSnapshot(Snapshot::Reader &reader) {
+    BaseChannelType::loadSnapshot(reader);
+    WaveChannelType::loadSnapshot(reader);
+}
@@ -25,6 +25,9 @@ namespace FunkyBoy::Sound {
     typedef struct ChannelThreeType : BaseChannel, WaveChannel {
         void serialize(std::ostream &stream) const override;
         void deserialize(std::istream &stream) override;
+
+        void saveSnapshot(Snapshot::Writer &writer) const override;
+        void loadSnapshot(Snapshot::Reader &reader) override;
     } ChannelThree;
 
 }
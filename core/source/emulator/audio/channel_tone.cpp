@@ -27,3 +27,13 @@ void ToneChannelType::deserialize(std::istream &stream) {
     EnvelopeChannelType::deserialize(stream);
     WaveChannelType::deserialize(stream);
 }
+
+void ToneChannelType::saveSnapshot(Snapshot::Writer &writer) const {
+    EnvelopeChannelType::saveSnapshot(writer);
+    WaveChannelType::saveSnapshot(writer);
+}
+
+void ToneChannelType::loadSnapshot(Snapshot::Reader &reader) {
+    EnvelopeChannelType::loadSnapshot(reader);
+    WaveChannelType::loadSnapshot(reader);
+}
@@ -25,3 +25,11 @@ void WaveChannelType::serialize(std::ostream &stream) const {
 void WaveChannelType::deserialize(std::istream &stream) {
     wavePosition = stream.get();
 }
+
+void WaveChannelType::saveSnapshot(Snapshot::Writer &writer) const {
+    writer.write(wavePosition);
+}
+
+void WaveChannelType::loadSnapshot(Snapshot::Reader &reader) {
+    reader.read(wavePosition);
+}
@@ -18,6 +18,7 @@
 #define FB_CORE_EMULATOR_CHANNEL_WAVE_H
 
 #include <util/typedefs.h>
+#include <util/snapshot.h>
 #include <iostream>
 
 namespace FunkyBoy::Sound {
@@ -27,6 +28,9 @@ namespace FunkyBoy::Sound {
 
         virtual void serialize(std::ostream &stream) const;
         virtual void deserialize(std::istream &stream);
+
+        virtual void saveSnapshot(Snapshot::Writer &writer) const;
+        virtual void loadSnapshot(Snapshot::Reader &reader);
     } WaveChannel;
 
 }
@@ -0,0 +1,254 @@
+/**
+ * Copyright 2021 Michel Kremer (kremi151)
+ *
+ * Licensed under the Apache License, Version 2.0 (the License);
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "block_cache.h"
+
+#include <operands/tables.h>
+#include <operands/reads.h>
+#include <operands/prefix.h>
+#include <emulator/io_registers.h>
+
+#define FB_BLOCK_CACHE_SLOTS 1024
+#define FB_BLOCK_MAX_INSTRUCTIONS 64
+#define FB_BLOCK_RAM_KEY 0x80000000u
+
+using namespace FunkyBoy;
+
+namespace FunkyBoy {
+
+    inline u8 countImmediates(const Operand *operands) {
+        u8 count = 0;
+        for (; *operands != nullptr ; operands++) {
+            if (*operands == Operands::readLSB
+                || *operands == Operands::readMSB
+                || *operands == Operands::readSigned
+                || *operands == Operands::readMemAsLSB
+                || *operands == Operands::decodePrefix) {
+                count++;
+            }
+        }
+        return count;
+    }
+
+    inline bool endsBlock(u8 opcode) {
+        switch (opcode) {
+            case 0x10: // STOP
+            case 0x76: // HALT
+            case 0x18: case 0x20: case 0x28: case 0x30: case 0x38: // JR
+            case 0xC2: case 0xC3: case 0xCA: case 0xD2: case 0xDA: case 0xE9: // JP
+            case 0xC4: case 0xCC: case 0xCD: case 0xD4: case 0xDC: // CALL
+            case 0xC0: case 0xC8: case 0xC9: case 0xD0: case 0xD8: case 0xD9: // RET, RETI
+            case 0xC7: case 0xCF: case 0xD7: case 0xDF: case 0xE7: case 0xEF: case 0xF7: case 0xFF: // RST
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    inline bool readsLCDRegister(memory_address address, IdleLoop &loop) {
+        if (address == FB_REG_LY) {
+            loop.readsLY = true;
+            return true;
+        } else if (address == FB_REG_STAT) {
+            loop.readsSTAT = true;
+            return true;
+        }
+        return false;
+    }
+
+    // Returns whether the result of the instruction only depends on the registers, LY and STAT
+    inline bool isIdleLoopInstruction(const DecodedInstruction &instruction, IdleLoop &loop) {
+        u8 opcode = instruction.opcode;
+        if (opcode >= 0x40 && opcode <= 0xBF) {
+            // Loads between registers and ALU operations, except for HALT and accesses to (HL)
+            return (opcode & 0x07u) != 0x06u && (opcode & 0xF8u) != 0x70u;
+        }
+        switch (opcode) {
+            case 0x00: // NOP
+            case 0xC6: case 0xCE: case 0xD6: case 0xDE: case 0xE6: case 0xEE: case 0xF6: case 0xFE: // ALU A,u8
+                return true;
+            case 0xF0: // LD A,(FF00+u8)
+                return readsLCDRegister(0xFF00u | instruction.immediates[0], loop);
+            case 0xFA: // LD A,(u16)
+                return readsLCDRegister(instruction.immediates[0] | (instruction.immediates[1] << 8u), loop);
+            default:
+                return false;
+        }
+    }
+
+    // Returns the address a taken branch continues at, or -1 if it is not known in advance
+    inline i32 getBranchTarget(const DecodedInstruction &instruction) {
+        switch (instruction.opcode) {
+            case 0x18: case 0x20: case 0x28: case 0x30: case 0x38: // JR
+                return (instruction.address + 2 + static_cast<i8>(instruction.immediates[0])) & 0xFFFF;
+            case 0xC2: case 0xC3: case 0xCA: case 0xD2: case 0xDA: // JP
+                return instruction.immediates[0] | (instruction.immediates[1] << 8u);
+            default:
+                return -1;
+        }
+    }
+
+    inline size_t getSlotIndex(u32 key) {
+        return (key * 2654435761u) >> 22u; // 10 bits -> FB_BLOCK_CACHE_SLOTS
+    }
+
+}
+
+BlockCache::BlockCache()
+    : slots(FB_BLOCK_CACHE_SLOTS, Slot{0, nullptr})
+    , romVersion(0)
+    , codeVersion(0)
+    , ramCodeVersion(0)
+    , blocksEntered(0)
+    , next(nullptr)
+    , end(nullptr)
+{
+}
+
+void BlockCache::clear() {
+    romBlocks.clear();
+    ramBlocks.clear();
+    std::fill(slots.begin(), slots.end(), Slot{0, nullptr});
+    resetChain();
+}
+
+void BlockCache::sync(Memory &memory) {
+    if (romVersion != memory.getROMVersion()) {
+        clear();
+        romVersion = memory.getROMVersion();
+        codeVersion = memory.getCodeVersion();
+        ramCodeVersion = memory.getRAMCodeVersion();
+    } else if (ramCodeVersion != memory.getRAMCodeVersion()) {
+        // Blocks in ROM are keyed by their bank, so only blocks in RAM have to be dropped
+        ramBlocks.clear();
+        for (auto &slot : slots) {
+            if (slot.key & FB_BLOCK_RAM_KEY) {
+                slot = Slot{0, nullptr};
+            }
+        }
+        resetChain();
+        codeVersion = memory.getCodeVersion();
+        ramCodeVersion = memory.getRAMCodeVersion();
+    } else if (codeVersion != memory.getCodeVersion()) {
+        // ROM banks have been switched, which only affects the block which is currently being followed
+        resetChain();
+        codeVersion = memory.getCodeVersion();
+    }
+}
+
+const DecodedInstruction *BlockCache::enterBlock(Memory &memory, memory_address address) {
+    sync(memory);
+    blocksEntered++;
+
+    u32 key;
+    u32 limit;
+    std::unordered_map<u32, DecodedBlock> *blocks;
+    if (address <= 0x7FFF) {
+        u32 bankOffset = memory.getROMBank(address) * 0x4000u;
+        if (bankOffset + 0x4000 > memory.getROMLength()) {
+            // Bank is not entirely backed by the ROM image, so we let the CPU read it as usual
+            resetChain();
+            return nullptr;
+        }
+        key = bankOffset | (address & 0x3FFFu);
+        limit = (address & 0x4000u) + 0x4000;
+        blocks = &romBlocks;
+    } else if (address >= 0xC000 && address <= 0xDFFF) {
+        key = FB_BLOCK_RAM_KEY | address;
+        limit = 0xE000;
+        blocks = &ramBlocks;
+    } else if (address >= 0xFF80 && address <= 0xFFFE) {
+        key = FB_BLOCK_RAM_KEY | address;
+        limit = 0xFFFF;
+        blocks = &ramBlocks;
+    } else {
+        resetChain();
+        return nullptr;
+    }
+
+    Slot &slot = slots[getSlotIndex(key)];
+    if (slot.block == nullptr || slot.key != key) {
+        auto it = blocks->find(key);
+        if (it == blocks->end()) {
+            DecodedBlock &block = (*blocks)[key];
+            buildBlock(memory, address, limit, block);
+            if (blocks == &ramBlocks && !block.empty()) {
+                const DecodedInstruction &last = block.back();
+                memory.markRAMCode(address, last.address - address + 1 + countImmediates(last.operands));
+            }
+            slot = Slot{key, &block};
+        } else {
+            slot = Slot{key, &it->second};
+        }
+    }
+
+    const DecodedBlock &block = *slot.block;
+    if (block.empty()) {
+        resetChain();
+        return nullptr;
+    }
+    next = block.data() + 1;
+    end = block.data() + block.size();
+    return block.data();
+}
+
+void BlockCache::buildBlock(Memory &memory, memory_address address, u32 limit, DecodedBlock &block) {
+    u32 offset = address;
+    while (block.size() < FB_BLOCK_MAX_INSTRUCTIONS) {
+        u8 opcode = memory.read8BitsAt(offset);
+        const Operand *operands = Operands::Tables::instructions[opcode];
+        if (operands == nullptr) {
+            // Illegal instructions are reported by the CPU
+            break;
+        }
+        DecodedInstruction instruction{operands, static_cast<memory_address>(offset), opcode, {0, 0}, {0, false, false}};
+        u8 immediates = countImmediates(operands);
+        if (immediates > sizeof(instruction.immediates) || offset + 1 + immediates > limit) {
+            break;
+        }
+        for (u8 i = 0 ; i < immediates ; i++) {
+            instruction.immediates[i] = memory.read8BitsAt(offset + 1 + i);
+        }
+        block.push_back(instruction);
+        offset += 1 + immediates;
+        if (endsBlock(opcode)) {
+            break;
+        }
+    }
+    detectIdleLoop(block);
+}
+
+void BlockCache::detectIdleLoop(DecodedBlock &block) {
+    if (block.empty() || getBranchTarget(block.back()) != static_cast<i32>(block.front().address)) {
+        return;
+    }
+    IdleLoop loop{0, false, false};
+    u32 cycles = 0;
+    for (auto it = block.begin() ; it != block.end() ; it++) {
+        if (it + 1 != block.end() && !isIdleLoopInstruction(*it, loop)) {
+            return;
+        }
+        // Every operand takes one machine cycle, and a taken branch runs all of them
+        for (const Operand *operand = it->operands ; *operand != nullptr ; operand++) {
+            cycles++;
+        }
+    }
+    if (cycles <= 0xFF) {
+        loop.cycles = cycles;
+        block.front().idleLoop = loop;
+    }
+}
@@ -0,0 +1,106 @@
+/**
+ * Copyright 2021 Michel Kremer (kremi151)
+ *
+ * Licensed under the Apache License, Version 2.0 (the License);
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef FB_CORE_BLOCK_CACHE_H
+#define FB_CORE_BLOCK_CACHE_H
+
+#include <util/typedefs.h>
+#include <memory/memory.h>
+#include <operands/instruction_context.h>
+#include <unordered_map>
+#include <vector>
+
+namespace FunkyBoy {
+
+    // A basic block which branches back to its own start, and which neither writes to memory nor reads anything but
+    // immediate values, LY and STAT
+    struct IdleLoop {
+        // Machine cycles of a single iteration, or 0 if the block is no idle loop
+        u8 cycles;
+        bool readsLY;
+        bool readsSTAT;
+    };
+
+    struct DecodedInstruction {
+        const Operand *operands;
+        memory_address address;
+        u8 opcode;
+        // Bytes following the opcode (immediate values or the second byte of a prefixed instruction)
+        u8 immediates[2];
+        // Only set on the first instruction of a block
+        IdleLoop idleLoop;
+    };
+
+    typedef std::vector<DecodedInstruction> DecodedBlock;
+
+    /**
+     * Caches predecoded basic blocks, which are keyed by their start address and the ROM bank they are located in.
+     * Only code located in ROM, internal RAM or HRAM is cached.
+     */
+    class BlockCache {
+    private:
+        struct Slot {
+            u32 key;
+            const DecodedBlock *block;
+        };
+
+        std::unordered_map<u32, DecodedBlock> romBlocks;
+        std::unordered_map<u32, DecodedBlock> ramBlocks;
+        // Direct mapped lookup table in front of the block maps
+        std::vector<Slot> slots;
+
+        u32 romVersion;
+        u32 codeVersion;
+        u32 ramCodeVersion;
+
+        // Number of times a block has been entered instead of following the current one
+        u32 blocksEntered;
+
+        // The remaining instructions of the block which is currently being executed
+        const DecodedInstruction *next;
+        const DecodedInstruction *end;
+
+        const DecodedInstruction *enterBlock(Memory &memory, memory_address address);
+        void buildBlock(Memory &memory, memory_address address, u32 limit, DecodedBlock &block);
+        static void detectIdleLoop(DecodedBlock &block);
+        void sync(Memory &memory);
+    public:
+        BlockCache();
+
+        // Returns the instruction at the given address, or nullptr if it cannot be served from the cache
+        inline const DecodedInstruction *fetch(Memory &memory, memory_address address) {
+            if (next != end && next->address == address && codeVersion == memory.getCodeVersion()) {
+                return next++;
+            }
+            return enterBlock(memory, address);
+        }
+
+        // Stops following the current block, e.g. after the program counter has been changed from outside
+        inline void resetChain() {
+            next = end = nullptr;
+        }
+
+        inline u32 getBlocksEntered() const {
+            return blocksEntered;
+        }
+
+        void clear();
+    };
+
+}
+
+#endif //FB_CORE_BLOCK_CACHE_H
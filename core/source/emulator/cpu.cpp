@@ -24,7 +24,8 @@
 #include <operands/tables.h>
 #include <operands/prefix.h>
 #include <exception/read_exception.h>
-#include <exception/state_exception.h>
+#include <algorithm>
+#include <cstring>
 
 using namespace FunkyBoy;
 
@@ -35,6 +36,8 @@ CPU::CPU(GameBoyType gbType, const io_registers& ioRegisters)
     , timerOverflowingCycles(-1)
     , delayedTIMAIncrease(false)
     , joypadWasNotPressed(true)
+    , idleLoopHead(nullptr)
+    , idleLoopState()
 #ifdef FB_DEBUG_WRITE_EXECUTION_LOG
     , file("exec_opcodes_fb_v2.txt")
     , instr(0)
@@ -68,6 +71,7 @@ void CPU::powerUpInit(Memory &memory) {
     } else {
         *instrContext.regA = 0x01;
     }
+    instrContext.materializeFlags();
     *instrContext.regF = 0xb0;
 
     // BC -> 0x0013
@@ -126,12 +130,18 @@ void CPU::powerUpInit(Memory &memory) {
 }
 
 ret_code CPU::doMachineCycle(Memory &memory) {
-    doJoypad();
-    auto result = doCycle(memory);
+    auto result = doInstructionCycle(memory);
 
     // TODO: Handle timer here or earlier?
     doTimers(memory, 4);
 
+    return result;
+}
+
+ret_code CPU::doInstructionCycle(Memory &memory) {
+    doJoypad();
+    auto result = doCycle(memory);
+
     // Due to a hardware quirk, enabling interrupts becomes active after the instruction following an EI,
     // so we simulate this behaviour here
     switch(instrContext.interruptMasterEnable) {
@@ -166,12 +176,14 @@ ret_code CPU::doCycle(Memory &memory) {
 
         if (*(++operands) == nullptr) {
             shouldFetch = true;
-            result |= FB_RET_INSTRUCTION_DONE;
         }
 
         if (!op(instrContext, memory)) {
             shouldFetch = true;
         }
+        if (shouldFetch) {
+            result |= FB_RET_INSTRUCTION_DONE;
+        }
         shouldDoInterrupts = shouldFetch;
     }
 
@@ -197,11 +209,29 @@ ret_code CPU::doCycle(Memory &memory) {
 
 ret_code CPU::doFetchAndDecode(Memory &memory) {
     if (!instrContext.haltBugRequested) {
+        auto decoded = blockCache.fetch(memory, instrContext.progCounter);
+        if (decoded != nullptr) {
+            instrContext.instr = decoded->opcode;
+            instrContext.immediates = decoded->immediates;
+            instrContext.progCounter++;
+#ifdef FB_DEBUG_WRITE_EXECUTION_LOG
+            FunkyBoy::Debug::writeExecutionToLog('I', file, instrContext, memory);
+            instr++;
+#endif
+            operands = decoded->operands;
+            if (decoded->idleLoop.cycles != 0) {
+                idleLoopHead = decoded;
+            }
+            return FB_RET_SUCCESS;
+        }
         instrContext.instr = memory.read8BitsAt(instrContext.progCounter++);
     } else {
+        // The byte following HALT is read twice, so the predecoded immediates cannot be used
+        blockCache.resetChain();
         instrContext.instr = memory.read8BitsAt(instrContext.progCounter);
         instrContext.haltBugRequested = false;
     }
+    instrContext.immediates = nullptr;
 
 #ifdef FB_DEBUG_WRITE_EXECUTION_LOG
     FunkyBoy::Debug::writeExecutionToLog('I', file, instrContext, memory);
@@ -216,6 +246,94 @@ ret_code CPU::doFetchAndDecode(Memory &memory) {
     return FB_RET_SUCCESS;
 }
 
+#ifdef FB_USE_JIT
+const CompiledBlock *CPU::getCompiledBlock(Memory &memory) {
+    memory_address address = instrContext.progCounter - 1;
+    // Only instructions which have just been fetched from ROM using the block cache are candidates, which also rules
+    // out the HALT bug. Blocks skip DMA transfers and the IME delay, and compiled code only preserves the lower
+    // nibble of register F if it is zero. An interrupt which has been requested in the last machine cycle or which
+    // is requested for changed inputs has to be serviced right after the first instruction.
+    if (instrContext.immediates == nullptr
+        || address >= 0x8000
+        || operands != Operands::Tables::instructions[instrContext.instr]
+        || memory.isDMAActive()
+        || instrContext.interruptMasterEnable == IMEState::REQUEST_ENABLE
+        || instrContext.interruptMasterEnable == IMEState::ENABLING
+        || (instrContext.interruptMasterEnable == IMEState::ENABLED
+            && (ioRegisters.getIF() & memory.getIE() & 0x1fu))
+        || ioRegisters.haveInputsChanged()) {
+        return nullptr;
+    }
+    // Compiled code works on register F directly
+    instrContext.materializeFlags();
+    if ((*instrContext.regF & 0x0fu) != 0) {
+        return nullptr;
+    }
+    return jit.lookup(memory, address);
+}
+
+ret_code CPU::runCompiledBlock(Memory &memory, const CompiledBlock &block, u8_fast count, bool verify) {
+    memory_address address = instrContext.progCounter - 1;
+    const CompiledInstruction &last = block.instructions[count - 1];
+    if (verify) {
+        u8 registers[8];
+        std::memcpy(registers, instrContext.registers, sizeof(registers));
+        block.code(registers, count);
+
+        instrContext.progCounter = address;
+        u8_fast cycles = 0;
+        for (u8_fast i = 0 ; i < count ; i++) {
+            auto &instruction = block.instructions[i];
+            instrContext.instr = instruction.opcode;
+            instrContext.immediates = instruction.immediates;
+            instrContext.progCounter++;
+            for (auto op = instruction.operands ; *op != nullptr ; op++) {
+                cycles++;
+                if (!(*op)(instrContext, memory)) {
+                    break;
+                }
+            }
+        }
+        instrContext.materializeFlags();
+
+        if (std::memcmp(registers, instrContext.registers, sizeof(registers)) != 0
+            || cycles != last.cycles
+            || instrContext.progCounter != static_cast<u16>(address + last.length)
+            || (last.lsb >= 0 && instrContext.lsb != last.lsb)
+            || (last.msb >= 0 && instrContext.msb != last.msb)) {
+            fprintf(stderr, "Compiled block at 0x%04X diverges from the interpreter after %u instructions\n",
+                    static_cast<unsigned>(address), static_cast<unsigned>(count));
+            fprintf(stderr, "Compiled:    B=%02X C=%02X D=%02X E=%02X H=%02X L=%02X F=%02X A=%02X cycles=%u\n",
+                    registers[0], registers[1], registers[2], registers[3],
+                    registers[4], registers[5], registers[6], registers[7], last.cycles);
+            fprintf(stderr, "Interpreted: B=%02X C=%02X D=%02X E=%02X H=%02X L=%02X F=%02X A=%02X cycles=%u\n",
+                    *instrContext.regB, *instrContext.regC, *instrContext.regD, *instrContext.regE,
+                    *instrContext.regH, *instrContext.regL, *instrContext.regF, *instrContext.regA,
+                    static_cast<unsigned>(cycles));
+            return 0;
+        }
+    } else {
+        block.code(instrContext.registers, count);
+        instrContext.progCounter = address + last.length;
+        if (last.lsb >= 0) {
+            instrContext.lsb = last.lsb;
+        }
+        if (last.msb >= 0) {
+            instrContext.msb = last.msb;
+        }
+    }
+
+    // Remainder of the last machine cycle, see doInstructionCycle()
+    doJoypad();
+#if defined(FB_TESTING)
+    instructionCompleted = true;
+#endif
+    // The CPU is running, so a serviced interrupt only changes the address to fetch from
+    doInterrupts(memory);
+    return FB_RET_SUCCESS | FB_RET_INSTRUCTION_DONE | doFetchAndDecode(memory);
+}
+#endif
+
 inline memory_address getInterruptStartAddress(InterruptType type) {
     // VBLANK   -> 0x0040
     // LCD_STAT -> 0x0048
@@ -246,6 +364,8 @@ bool CPU::doInterrupts(Memory &memory) {
     if (instrContext.cpuState == CPUState::STOPPED) {
         return false;
     }
+    // Interrupts may have been requested by components which are lagging behind
+    memory.catchUpInterrupts();
     u8 &_if = ioRegisters.getIF();
     _if %= 0x1fu;
     u8 _ie = memory.getIE() & 0x1fu;
@@ -281,49 +401,49 @@ bool CPU::doInterrupts(Memory &memory) {
     return false;
 }
 
-bool doTimerObscureCheck(u8 clocks, u16 sysCounter, u8 tac) {
-    while (clocks > 0) {
-        switch (tac & 0b11u) {
-            case 0u: {
-                if (sysCounter & 0b1000000000u) {
-                    return true;
-                }
-                break;
-            }
-            case 1u: {
-                if (sysCounter & 0b1000u) {
-                    return true;
-                }
-                break;
-            }
-            case 2u: {
-                if (sysCounter & 0b100000u) {
-                    return true;
-                }
-                break;
-            }
-            case 3u: {
-                if (sysCounter & 0b10000000u) {
-                    return true;
-                }
-                break;
-            }
-            default: {
-                fprintf(stderr, "Illegal timer frequency\n");
-                return false;
-            }
+namespace FunkyBoy {
+
+    // Bit of the system counter whose falling edge increases TIMA, for each frequency selected by TAC
+    const u16 TimerBits[4] = {
+            0b1000000000u,
+            0b1000u,
+            0b100000u,
+            0b10000000u,
+    };
+
+}
+
+// Returns whether the timer bit is set in any of the clocks of the machine cycle starting at the given system counter
+inline bool isTimerBitSet(u16 sysCounter, u8 tac) {
+    const u16 bit = TimerBits[tac & 0b11u];
+    return (sysCounter & bit) || (static_cast<u16>(sysCounter + 3) & bit);
+}
+
+void CPU::doTimers(Memory &memory, u32_fast clocks) {
+    u32_fast cycles = clocks / 4;
+    while (cycles > 0) {
+        // Machine cycles before the next falling edge only advance the system counter, so they are skipped at once
+        u32_fast edge = timerOverflowingCycles == -1 ? getTimerEdgeCycle(1) : 1;
+        u32_fast idleCycles = edge == 0 ? cycles : std::min<u32_fast>(edge - 1, cycles);
+        if (idleCycles > 0) {
+            u16 sysCounter = ioRegisters.getSysCounter() + idleCycles * 4;
+            ioRegisters.setSysCounter(sysCounter);
+            u8 tac = ioRegisters.getTAC();
+            delayedTIMAIncrease = (tac & 0b100u) && isTimerBitSet(sysCounter - 4, tac);
+            cycles -= idleCycles;
+            continue;
         }
-        sysCounter++;
-        clocks--;
+        doTimerCycle();
+        cycles--;
     }
-    return false;
 }
 
-void CPU::doTimers(Memory &memory, u8 clocks) {
+void CPU::doTimerCycle() {
+    // The timer circuit is evaluated once per machine cycle
     u16 sysCounter = ioRegisters.getSysCounter();
-    ioRegisters.setSysCounter(sysCounter + clocks); // TODO: Move to end of this function?
+    ioRegisters.setSysCounter(sysCounter + 4); // TODO: Move to end of this function?
     if (timerOverflowingCycles != -1) {
-        timerOverflowingCycles -= clocks;
+        timerOverflowingCycles -= 4;
         if (timerOverflowingCycles <= 0) {
             //fprintf(stdout, "# Request Timer interrupt\n");
             ioRegisters.getTIMA() = ioRegisters.getTMA();
@@ -333,7 +453,7 @@ void CPU::doTimers(Memory &memory, u8 clocks) {
     }
     u8 tac = ioRegisters.getTAC();
     bool comp1 = (tac & 0b100u) != 0;
-    comp1 &= doTimerObscureCheck(clocks, sysCounter, tac);
+    comp1 &= isTimerBitSet(sysCounter, tac);
     // Falling edge detector
     if (delayedTIMAIncrease && !comp1) {
         u8 tima = ioRegisters.getTIMA();
@@ -350,6 +470,88 @@ void CPU::doTimers(Memory &memory, u8 clocks) {
     delayedTIMAIncrease = comp1;
 }
 
+u32_fast CPU::getTimerEdgeCycle(u32_fast n) {
+    const u16 sysCounter = ioRegisters.getSysCounter();
+    const u8 tac = ioRegisters.getTAC();
+    const bool enabled = tac & 0b100u;
+    // The first machine cycle sees an edge if the timer bit was set in the previous one, which may also have been
+    // caused by writing to DIV or TAC
+    if (delayedTIMAIncrease && !(enabled && isTimerBitSet(sysCounter, tac))) {
+        if (--n == 0) {
+            return 1;
+        }
+    }
+    if (!enabled) {
+        return 0;
+    }
+    // Afterwards, edges occur whenever a machine cycle starts at a multiple of twice the timer bit
+    const u32_fast period = TimerBits[tac & 0b11u] * 2u;
+    u32_fast first = 1 + ((period - sysCounter % period) % period) / 4;
+    if (first < 2) {
+        first += period / 4;
+    }
+    return first + (n - 1) * (period / 4);
+}
+
+u32_fast CPU::getCyclesUntilTimerInterrupt(u32_fast maxCycles) {
+    if (timerOverflowingCycles != -1) {
+        return 1;
+    }
+    // The interrupt is requested one machine cycle after the edge which lets TIMA overflow
+    u32_fast edge = getTimerEdgeCycle(0x100u - ioRegisters.getTIMA());
+    return edge == 0 ? maxCycles : std::min<u32_fast>(maxCycles, edge + 1);
+}
+
+u32_fast CPU::getUninterruptedCycles(u32_fast maxCycles) {
+    // Enabling interrupts is delayed, which has to be done one machine cycle at a time
+    if (instrContext.interruptMasterEnable == IMEState::REQUEST_ENABLE
+        || instrContext.interruptMasterEnable == IMEState::ENABLING) {
+        return 1;
+    }
+    return getCyclesUntilTimerInterrupt(maxCycles);
+}
+
+void CPU::skipCycles(u32_fast cycles) {
+    if (cycles > 0) {
+        // No inputs can have changed in the meantime
+        doJoypad();
+    }
+}
+
+const IdleLoop *CPU::getIdleLoop(Memory &memory) {
+    const DecodedInstruction *head = idleLoopHead;
+    idleLoopHead = nullptr;
+    // The head has to be the current instruction, which has not started yet
+    if (head == nullptr || operands != head->operands || instrContext.immediates != head->immediates
+        || instrContext.cpuState != CPUState::RUNNING || memory.isDMAActive()) {
+        return nullptr;
+    }
+    // An interrupt which has been requested in the last machine cycle is serviced after the next instruction
+    if (instrContext.interruptMasterEnable == IMEState::ENABLED && (ioRegisters.getIF() & memory.getIE() & 0x1fu)) {
+        return nullptr;
+    }
+    instrContext.materializeFlags();
+    u32 blocksEntered = blockCache.getBlocksEntered();
+    u8 ly = ioRegisters.getLY();
+    u8 stat = ioRegisters.getSTAT();
+    // If no other block has been entered since the last time the head was fetched, exactly one iteration has run in
+    // between. LY and STAT cannot return to the same values within that time once they changed.
+    bool unchanged = idleLoopState.head == head
+            && idleLoopState.blocksEntered + 1 == blocksEntered
+            && idleLoopState.ly == ly
+            && idleLoopState.stat == stat
+            && std::memcmp(idleLoopState.registers, instrContext.registers, sizeof(idleLoopState.registers)) == 0;
+    idleLoopState.blocksEntered = blocksEntered;
+    if (!unchanged) {
+        idleLoopState.head = head;
+        idleLoopState.ly = ly;
+        idleLoopState.stat = stat;
+        std::memcpy(idleLoopState.registers, instrContext.registers, sizeof(idleLoopState.registers));
+        return nullptr;
+    }
+    return &head->idleLoop;
+}
+
 void CPU::requestInterrupt(InterruptType type) {
     //fprintf(stdout, "#req int %d\n", type);
     u8 &_if = ioRegisters.getIF();
@@ -361,48 +563,45 @@ void CPU::setProgramCounter(u16 offset) {
 }
 
 u16 CPU::readAF() {
+    instrContext.materializeFlags();
     return (*instrContext.regF & 0b11110000) | (*instrContext.regA << 8);
 }
 
 void CPU::writeAF(FunkyBoy::u16 val) {
+    instrContext.materializeFlags();
     *instrContext.regF = val & 0b11110000; // Only the 4 most significant bits are written to register F
     *instrContext.regA = (val >> 8) & 0xff;
 }
 
-void CPU::serialize(std::ostream &ostream) const {
-    instrContext.serialize(ostream);
+u8 CPU::getOperandIndex() const {
+    // Operands always point into the operand list of the current instruction, so its index can be computed directly
+    if (instrContext.instr == 0xCB) {
+        const Operand *decodePrefix = Operands::Tables::instructions[0xCB];
+        if (operands == decodePrefix || operands == decodePrefix + 1) {
+            return operands - decodePrefix;
+        }
+        // Indexes 0 and 1 are taken by Operands::decodePrefix and Operands::prefixPlaceholder
+        return operands - Operands::Tables::prefixInstructions[instrContext.cbInstr] + 2;
+    }
+    return operands - Operands::Tables::instructions[instrContext.instr];
+}
 
-    const Operand *operandTable;
-    u8 operandIndex;
+void CPU::setOperandIndex(u8 operandIndex) {
     if (instrContext.instr == 0xCB) {
-        if (*operands == Operands::decodePrefix) {
-            operandIndex = 0;
-        } else if (*operands == Operands::prefixPlaceholder) {
-            operandIndex = 1;
+        if (operandIndex < 2) {
+            operands = Operands::Tables::instructions[0xCB] + operandIndex;
         } else {
-            operandTable = Operands::Tables::prefixInstructions[instrContext.cbInstr];
-            for (int i = 0 ;; i++) {
-                if (*(operandTable++) == *operands) {
-                    operandIndex = i + 2; // For Operands::decodePrefix and Operands::prefixPlaceholder
-                    break;
-                } else if (*operandTable == nullptr) {
-                    throw Exception::WrongStateException("Prefix operand index could not be determined");
-                }
-            }
+            operands = Operands::Tables::prefixInstructions[instrContext.cbInstr] + (operandIndex - 2);
         }
     } else {
-        operandTable = Operands::Tables::instructions[instrContext.instr];
-        for (int i = 0 ;; i++) {
-            auto &operand = *(operandTable++);
-            if (operand == *operands) {
-                operandIndex = i;
-                break;
-            } else if (operand == nullptr) {
-                throw Exception::WrongStateException("Operand index could not be determined");
-            }
-        }
+        operands = Operands::Tables::instructions[instrContext.instr] + operandIndex;
     }
-    ostream.put(operandIndex);
+}
+
+void CPU::serialize(std::ostream &ostream) const {
+    instrContext.serialize(ostream);
+
+    ostream.put(getOperandIndex());
 
     ostream.put(timerOverflowingCycles);
     ostream.put(delayedTIMAIncrease);
@@ -411,6 +610,9 @@ void CPU::serialize(std::ostream &ostream) const {
 
 void CPU::deserialize(std::istream &istream) {
     instrContext.deserialize(istream);
+    blockCache.resetChain();
+    idleLoopHead = nullptr;
+    idleLoopState.head = nullptr;
 
     char buffer[4];
     istream.read(buffer, sizeof(buffer));
@@ -418,20 +620,31 @@ void CPU::deserialize(std::istream &istream) {
         throw Exception::ReadException("Stream is too short (CPU)");
     }
 
-    u8 operandIndex = buffer[0];
-    if (instrContext.instr == 0xCB) {
-        if (operandIndex == 0) {
-            operands = Operands::Tables::instructions[0xCB];
-        } else if (operandIndex == 1) {
-            operands = Operands::Tables::instructions[0xCB] + 1;
-        } else {
-            operands = Operands::Tables::prefixInstructions[instrContext.cbInstr] + (operandIndex - 2);
-        }
-    } else {
-        operands = Operands::Tables::instructions[instrContext.instr] + operandIndex;
-    }
+    setOperandIndex(buffer[0]);
 
     timerOverflowingCycles = buffer[1];
     delayedTIMAIncrease = buffer[2];
     joypadWasNotPressed = buffer[3];
+}
+
+void CPU::saveSnapshot(Snapshot::Writer &writer) const {
+    instrContext.saveSnapshot(writer);
+    writer.write(getOperandIndex());
+    writer.write(timerOverflowingCycles);
+    writer.write(delayedTIMAIncrease);
+    writer.write(joypadWasNotPressed);
+}
+
+void CPU::loadSnapshot(Snapshot::Reader &reader) {
+    instrContext.loadSnapshot(reader);
+    blockCache.resetChain();
+    idleLoopHead = nullptr;
+    idleLoopState.head = nullptr;
+
+    u8 operandIndex;
+    reader.read(operandIndex);
+    setOperandIndex(operandIndex);
+    reader.read(timerOverflowingCycles);
+    reader.read(delayedTIMAIncrease);
+    reader.read(joypadWasNotPressed);
 }
\ No newline at end of file
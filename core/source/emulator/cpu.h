@@ -23,10 +23,13 @@
 #include <iostream>
 #include <util/testing.h>
 #include <util/debug.h>
+#include <util/snapshot.h>
 #include <operands/instruction_context.h>
 #include <operands/debug.h>
 #include <emulator/gb_type.h>
 #include <emulator/io_registers.h>
+#include <emulator/block_cache.h>
+#include <emulator/jit.h>
 
 #ifdef FB_DEBUG_WRITE_EXECUTION_LOG
 #include <fstream>
@@ -57,12 +60,37 @@ namespace FunkyBoy {
 
         bool joypadWasNotPressed;
 
+        BlockCache blockCache;
+
+        // First instruction of an idle loop which has been fetched last
+        const DecodedInstruction *idleLoopHead;
+        // State at the beginning of the last iteration of an idle loop
+        struct {
+            const DecodedInstruction *head;
+            u32 blocksEntered;
+            u8 registers[8];
+            u8 ly;
+            u8 stat;
+        } idleLoopState;
+
+#ifdef FB_USE_JIT
+        JIT jit;
+#endif
+
         ret_code doCycle(Memory &memory);
         ret_code doFetchAndDecode(Memory &memory);
 
         void doJoypad();
         bool doInterrupts(Memory &memory);
-        void doTimers(Memory &memory, u8 clocks);
+
+        void doTimerCycle();
+        // Returns the machine cycle (counting from 1) of the n-th falling edge of the timer from now, or 0 if there
+        // is none
+        u32_fast getTimerEdgeCycle(u32_fast n);
+
+        // Index of the operand to be executed next within the operand list of the current instruction
+        u8 getOperandIndex() const;
+        void setOperandIndex(u8 operandIndex);
 
     test_public:
 
@@ -82,13 +110,58 @@ namespace FunkyBoy {
 
         void powerUpInit(Memory &memory);
 
+        inline CPUState getState() const {
+            return instrContext.cpuState;
+        }
+
         void setProgramCounter(u16 offset);
+
+        // Returns the address of the instruction which has been fetched last and which is executed next
+        inline u16 getFetchedInstructionAddress() const {
+            return instrContext.progCounter - 1;
+        }
+
         void requestInterrupt(InterruptType type);
 
         ret_code doMachineCycle(Memory &memory);
 
+        // Same as doMachineCycle, but without advancing the timers, which have to be caught up separately using doTimers
+        ret_code doInstructionCycle(Memory &memory);
+        void doTimers(Memory &memory, u32_fast clocks);
+        // Returns the machine cycle (counting from 1) in which the timers will request an interrupt next, or
+        // maxCycles if they do not request one before
+        u32_fast getCyclesUntilTimerInterrupt(u32_fast maxCycles);
+
+        // Returns the number of machine cycles a halted CPU or an idle loop can be advanced by at once, which ends
+        // with the first machine cycle in which the timers request an interrupt, but is at most maxCycles
+        u32_fast getUninterruptedCycles(u32_fast maxCycles);
+        // Does the work of a halted CPU or of an idle loop for the given number of machine cycles following
+        // doInstructionCycle(), in which no interrupt has been requested
+        void skipCycles(u32_fast cycles);
+
+        // Returns the idle loop whose first instruction has just been fetched, if its last iteration neither changed
+        // any register nor saw LY or STAT change. Each further iteration then behaves the same until LY or STAT
+        // change or an interrupt is requested. Returns nullptr otherwise.
+        const IdleLoop *getIdleLoop(Memory &memory);
+
+        inline bool hasFetchedIdleLoop() const {
+            return idleLoopHead != nullptr;
+        }
+
+#ifdef FB_USE_JIT
+        // Returns the compiled block starting at the current instruction, or nullptr if it has to be interpreted
+        const CompiledBlock *getCompiledBlock(Memory &memory);
+        // Runs the first count instructions of a block returned by getCompiledBlock, including the interrupt check
+        // and the fetch which happen in the last machine cycle. If verify is set, the instructions are also
+        // interpreted and both results are compared.
+        ret_code runCompiledBlock(Memory &memory, const CompiledBlock &block, u8_fast count, bool verify);
+#endif
+
         void serialize(std::ostream &ostream) const;
         void deserialize(std::istream &istream);
+
+        void saveSnapshot(Snapshot::Writer &writer) const;
+        void loadSnapshot(Snapshot::Reader &reader);
     };
 
 }
@@ -21,7 +21,9 @@
 #include <emulator/gb_type.h>
 #include <cartridge/header.h>
 #include <exception/read_exception.h>
+#include <exception/state_exception.h>
 #include <cstring>
+#include <algorithm>
 
 namespace FunkyBoy {
 
@@ -38,8 +40,21 @@ namespace FunkyBoy {
 using namespace FunkyBoy;
 
 Emulator::Emulator(GameBoyType gbType)
-    : ioRegisters()
-    , ppuMemory()
+    : state(std::make_unique<MachineState>())
+    , gbType(gbType)
+    , executionMode(ExecutionMode::MACHINE_CYCLE)
+    , scheduler()
+    , syncedCycles(0)
+    , caughtUpResult(0)
+    , skippedCycles(0)
+    , lastFrameSkippedCycles(0)
+    , cycleLimit(std::numeric_limits<u64>::max())
+    , rewindInterval(0)
+    , framesUntilRewindSnapshot(0)
+    , breakpoints()
+    , breakpointCount(0)
+    , ioRegisters(state->io)
+    , ppuMemory(state->ppuMemory)
 #ifdef FB_USE_SOUND
     , apu(gbType, ioRegisters)
 #endif
@@ -49,11 +64,11 @@ Emulator::Emulator(GameBoyType gbType)
 #ifdef FB_USE_SOUND
             , &apu
 #endif
+            , &state->memory
     )
     , cpu(gbType, ioRegisters)
     , ppu(ioRegisters, ppuMemory)
 #ifdef FB_USE_AUTOSAVE
-    , cramLastWritten(-1)
     , savePath()
 #endif
 {
@@ -64,9 +79,53 @@ Emulator::Emulator(GameBoyType gbType)
 
     // Initialize registers
     cpu.powerUpInit(memory);
+
+    memory.setCatchUpCallback([this](bool interruptsOnly) {
+        if (!interruptsOnly || mayRequestInterrupt(0)) {
+            catchUp();
+        }
+    });
+    // Writes are preceded by catching up, so the affected events can be scheduled again right away
+    memory.setIOWrittenCallback([this](memory_address address) {
+        switch (address) {
+            case FB_REG_DIV:
+            case FB_REG_TIMA:
+            case FB_REG_TAC:
+            case FB_REG_LCDC:
+                scheduleEvents();
+                break;
+            default:
+                break;
+        }
+    });
+    scheduleEvents();
+}
+
+std::unique_ptr<Emulator> Emulator::clone(const Controller::Controllers &controllers) const {
+    auto emulator = std::make_unique<Emulator>(gbType);
+    emulator->setControllers(controllers);
+    emulator->executionMode = executionMode;
+    emulator->breakpoints = breakpoints;
+    emulator->breakpointCount = breakpointCount;
+    emulator->setSpriteLimitEnabled(isSpriteLimitEnabled());
+    emulator->setRenderPolicy(getRenderPolicy(), ppu.getRenderInterval());
+    emulator->ppu.getFrameBuffer().copyFrom(ppu.getFrameBuffer());
+    if (memory.getROMImage() != nullptr) {
+        emulator->loadGame(memory.getROMImage());
+    }
+    std::vector<u8> snapshot(getSnapshotSize());
+    Snapshot::Writer writer(snapshot.data());
+    writeSnapshot(writer);
+    emulator->loadSnapshot(snapshot.data(), snapshot.size());
+    return emulator;
+}
+
+void Emulator::setExecutionMode(ExecutionMode mode) {
+    executionMode = mode;
 }
 
 void Emulator::setControllers(const Controller::Controllers &controllers) {
+    this->controllers = std::make_shared<Controller::Controllers>(controllers);
 #ifdef FB_USE_SOUND
     apu.onControllersUpdated(controllers);
 #endif
@@ -75,13 +134,20 @@ void Emulator::setControllers(const Controller::Controllers &controllers) {
 }
 
 CartridgeStatus Emulator::loadGame(const fs::path &romPath) {
-    std::ifstream romFile(romPath.c_str(), std::ios::binary | std::ios::in);
-    return loadGame(romFile);
+    return loadGame(ROMImage::fromFile(romPath));
 }
 
 CartridgeStatus Emulator::loadGame(std::istream &stream) {
     memory.loadROM(stream);
+    return finishLoadingGame();
+}
+
+CartridgeStatus Emulator::loadGame(const ROMImagePtr &romImage) {
+    memory.loadROM(romImage);
+    return finishLoadingGame();
+}
 
+CartridgeStatus Emulator::finishLoadingGame() {
     if (memory.getCartridgeStatus() != CartridgeStatus::Loaded) {
         std::cerr << "ROM could not be loaded, status " << memory.getCartridgeStatus() << std::endl;
         return memory.getCartridgeStatus();
@@ -89,6 +155,11 @@ CartridgeStatus Emulator::loadGame(std::istream &stream) {
 
     cpu.setProgramCounter(FB_ROM_HEADER_ENTRY_POINT);
 
+    if (rewindBuffer) {
+        // Snapshots of the previous game cannot be restored, and the size of a snapshot depends on the cartridge
+        enableRewind(rewindBuffer->getCapacity(), rewindInterval);
+    }
+
 #ifdef FB_DEBUG
     auto header = memory.getROMHeader();
 
@@ -119,6 +190,8 @@ void Emulator::writeCartridgeRam(std::ostream &stream) {
 #define FB_SAVE_STATE_VERSION 3
 
 void Emulator::saveState(std::ostream &ostream) {
+    catchUp();
+
     ostream.put(FB_SAVE_STATE_VERSION);
     ostream.put(getFeatureBitmap());
 
@@ -181,6 +254,139 @@ void Emulator::loadState(std::istream &istream) {
     if (!istream) {
         throw Exception::ReadException("Stream is too short (Emulator)");
     }
+
+    // Cycles which have not been caught up belong to the replaced state
+    syncedCycles = scheduler.getCycles();
+    scheduleEvents();
+}
+
+void Emulator::writeSystemSnapshot(Snapshot::Writer &writer) const {
+    writer.write(*state);
+    cpu.saveSnapshot(writer);
+    ppu.saveSnapshot(writer);
+#ifdef FB_USE_SOUND
+    apu.saveSnapshot(writer);
+#endif
+    // Timers, PPU and APU are captured while they lag behind, so the scheduler is restored as well
+    writer.write(scheduler);
+    writer.write(syncedCycles);
+    writer.write(caughtUpResult);
+    writer.write(skippedCycles);
+    writer.write(lastFrameSkippedCycles);
+}
+
+void Emulator::readSystemSnapshot(Snapshot::Reader &reader) {
+    reader.read(*state);
+    ppuMemory.invalidateCache();
+    cpu.loadSnapshot(reader);
+    ppu.loadSnapshot(reader);
+#ifdef FB_USE_SOUND
+    apu.loadSnapshot(reader);
+#endif
+    reader.read(scheduler);
+    reader.read(syncedCycles);
+    reader.read(caughtUpResult);
+    reader.read(skippedCycles);
+    reader.read(lastFrameSkippedCycles);
+}
+
+void Emulator::writeSnapshot(Snapshot::Writer &writer) const {
+    writeSystemSnapshot(writer);
+    memory.saveSnapshot(writer);
+}
+
+size_t Emulator::getSnapshotSize() const {
+    Snapshot::Writer writer(nullptr);
+    writeSnapshot(writer);
+    return writer.getSize();
+}
+
+void Emulator::saveSnapshot(u8 *buffer, size_t size) const {
+    if (size < getSnapshotSize()) {
+        throw Exception::WrongStateException("Snapshot buffer is too small");
+    }
+    Snapshot::Writer writer(buffer);
+    writeSnapshot(writer);
+}
+
+void Emulator::loadSnapshot(const u8 *buffer, size_t size) {
+    if (size < getSnapshotSize()) {
+        throw Exception::ReadException("Snapshot is too short");
+    }
+    // The system part has the same size for every game, so the cartridge part can be checked before anything is
+    // restored
+    memory.checkSnapshot(Snapshot::Reader(buffer + getPowerUpSnapshot(gbType).size()));
+
+    Snapshot::Reader reader(buffer);
+    readSystemSnapshot(reader);
+    memory.loadSnapshot(reader);
+}
+
+const std::vector<u8> &Emulator::getPowerUpSnapshot(GameBoyType gbType) {
+    // The power-up state is the same for all instances of a type, so it is only captured once
+    auto capture = [](GameBoyType type) {
+        Emulator emulator(type);
+        Snapshot::Writer sizeWriter(nullptr);
+        emulator.writeSystemSnapshot(sizeWriter);
+        std::vector<u8> snapshot(sizeWriter.getSize());
+        Snapshot::Writer writer(snapshot.data());
+        emulator.writeSystemSnapshot(writer);
+        return snapshot;
+    };
+    static const std::vector<u8> snapshots[] = {
+            capture(GameBoyType::GameBoyDMG),
+            capture(GameBoyType::GameBoySGB),
+            capture(GameBoyType::GameBoyCGB)
+    };
+    return snapshots[gbType];
+}
+
+void Emulator::reset(bool keepCartridgeRam) {
+    Snapshot::Reader reader(getPowerUpSnapshot(gbType).data());
+    readSystemSnapshot(reader);
+    memory.reset(keepCartridgeRam);
+    ppu.getFrameBuffer().clear();
+    if (memory.getCartridgeStatus() == CartridgeStatus::Loaded) {
+        cpu.setProgramCounter(FB_ROM_HEADER_ENTRY_POINT);
+    }
+    if (rewindBuffer) {
+        rewindBuffer->clear();
+        framesUntilRewindSnapshot = rewindInterval;
+    }
+}
+
+// Number of deltas which are encoded against the same keyframe for rewinding
+#define FB_REWIND_KEYFRAME_INTERVAL 30
+
+void Emulator::enableRewind(size_t bufferSize, u32_fast frameInterval) {
+    size_t snapshotSize = getSnapshotSize();
+    rewindBuffer = std::make_unique<RewindBuffer>(snapshotSize, bufferSize, FB_REWIND_KEYFRAME_INTERVAL);
+    rewindSnapshot.resize(snapshotSize);
+    rewindInterval = std::max<u32_fast>(frameInterval, 1);
+    framesUntilRewindSnapshot = rewindInterval;
+}
+
+void Emulator::disableRewind() {
+    rewindBuffer.reset();
+    rewindSnapshot = std::vector<u8>();
+}
+
+void Emulator::captureRewindSnapshot() {
+    Snapshot::Writer writer(rewindSnapshot.data());
+    writeSnapshot(writer);
+    rewindBuffer->push(rewindSnapshot.data());
+    framesUntilRewindSnapshot = rewindInterval;
+}
+
+bool Emulator::rewind() {
+    if (!rewindBuffer || !rewindBuffer->pop(rewindSnapshot.data())) {
+        return false;
+    }
+    loadSnapshot(rewindSnapshot.data(), rewindSnapshot.size());
+    // The frame which is emulated to display the restored state is not captured, so that rewinding again goes back
+    // further instead of restoring it
+    framesUntilRewindSnapshot = rewindInterval + 1;
+    return true;
 }
 
 #ifdef FB_USE_AUTOSAVE
@@ -196,25 +402,234 @@ void Emulator::doAutosave() {
 }
 #endif
 
+// Upper bound for advancing a halted CPU or an idle loop at once, which corresponds to one frame
+#define FB_MAX_SKIPPED_CYCLES 17556
+
+// Cartridge RAM is written back once it has not been modified for 30 frames
+#define FB_AUTOSAVE_DELAY_CYCLES (30 * FB_MAX_SKIPPED_CYCLES)
+
 ret_code Emulator::doTick() {
-    auto result = cpu.doMachineCycle(memory);
+    ret_code result = executionMode != ExecutionMode::MACHINE_CYCLE ? doInstruction() : doMachineCycle();
+    if (!result) {
+        return 0;
+    }
+    if ((result & FB_RET_INSTRUCTION_DONE) && !(result & FB_RET_NEW_FRAME) && breakpointCount == 0) {
+        result |= skipIdleLoop();
+    }
+    if (result & FB_RET_NEW_FRAME) {
+        lastFrameSkippedCycles = skippedCycles;
+        skippedCycles = 0;
+    }
+#ifdef FB_USE_AUTOSAVE
+    if ((result & FB_RET_NEW_FRAME) && memory.cartridgeRAMWritten) {
+        memory.cartridgeRAMWritten = false;
+        scheduler.schedule(EventType::AUTOSAVE, scheduler.getCycles() + FB_AUTOSAVE_DELAY_CYCLES);
+    }
+#endif
+    if ((result & FB_RET_NEW_FRAME) && rewindBuffer && --framesUntilRewindSnapshot == 0) {
+        captureRewindSnapshot();
+    }
+    return result;
+}
+
+StopReason Emulator::runUntil(stop_mask stopMask, u64 maxCycles) {
+    u64 startCycles = scheduler.getCycles();
+    u32 serialTransferCount = memory.getSerialTransferCount();
+    bool stopAtBreakpoints = (stopMask & STOP_BREAKPOINT) && breakpointCount > 0;
+    cycleLimit = startCycles + std::min(maxCycles, std::numeric_limits<u64>::max() - startCycles);
+    StopReason reason;
+    while (true) {
+        ret_code result = doTick();
+        if (!result) {
+            reason = STOP_ILLEGAL_OPCODE;
+            break;
+        }
+        if ((stopMask & STOP_NEW_FRAME) && (result & FB_RET_NEW_FRAME)) {
+            reason = STOP_NEW_FRAME;
+            break;
+        }
+        if ((stopMask & STOP_SERIAL_BYTE) && memory.getSerialTransferCount() != serialTransferCount) {
+            reason = STOP_SERIAL_BYTE;
+            break;
+        }
+        // The next instruction has already been fetched once an instruction is done
+        if (stopAtBreakpoints && (result & FB_RET_INSTRUCTION_DONE)
+            && breakpoints.test(cpu.getFetchedInstructionAddress())) {
+            reason = STOP_BREAKPOINT;
+            break;
+        }
+        if (scheduler.getCycles() - startCycles >= maxCycles) {
+            reason = STOP_CYCLE_BUDGET;
+            break;
+        }
+    }
+    // Single ticks are not limited
+    cycleLimit = std::numeric_limits<u64>::max();
+    return reason;
+}
+
+void Emulator::setBreakpoint(memory_address address, bool enabled) {
+    address &= 0xFFFFu;
+    if (breakpoints.test(address) != enabled) {
+        breakpoints.set(address, enabled);
+        breakpointCount += enabled ? 1 : -1;
+    }
+}
+
+void Emulator::clearBreakpoints() {
+    breakpoints.reset();
+    breakpointCount = 0;
+}
+
+ret_code Emulator::doMachineCycle() {
+    auto result = cpu.doInstructionCycle(memory);
     if (!result) {
         return 0;
     }
-    result |= ppu.doClocks(cpu, 4);
+    u32_fast cycles = 1;
+    if (cpu.getState() == CPUState::HALTED) {
+        // A halted CPU only waits for an interrupt, so we advance up to the next machine cycle in which timers or PPU
+        // could request one at once, but not beyond the budget of runUntil
+        catchUp();
+        cycles = std::min<u32_fast>({
+                cpu.getUninterruptedCycles(FB_MAX_SKIPPED_CYCLES),
+                (ppu.getClocksUntilInterrupt(FB_MAX_SKIPPED_CYCLES * 4) + 3) / 4,
+                static_cast<u32_fast>(std::max<u64>(1, std::min<u64>(FB_MAX_SKIPPED_CYCLES, getCyclesUntilLimit())))
+        });
+        cpu.skipCycles(cycles - 1);
+        skippedCycles += cycles - 1;
+    }
+    scheduler.advance(cycles);
+    return result | finishTick();
+}
+
+ret_code Emulator::doInstruction() {
+    // A halted or stopped CPU does not run any instruction, so we only advance by a single machine cycle
+    if (cpu.getState() != CPUState::RUNNING) {
+        return doMachineCycle();
+    }
+#ifdef FB_USE_JIT
+    if ((executionMode == ExecutionMode::JIT || executionMode == ExecutionMode::JIT_VERIFY) && breakpointCount == 0) {
+        auto block = cpu.getCompiledBlock(memory);
+        if (block != nullptr) {
+            // A compiled block runs at once, so it has to stop before interrupts could be requested in between and
+            // before the budget of runUntil is used up
+            catchUp();
+            u8_fast count = block->instructions.size();
+            while (count > 0 && (mayRequestInterrupt(block->instructions[count - 1].cycles)
+                                 || block->instructions[count - 1].cycles > getCyclesUntilLimit())) {
+                count--;
+            }
+            if (count > 0) {
+                scheduler.advance(block->instructions[count - 1].cycles - 1);
+                ret_code result = cpu.runCompiledBlock(memory, *block, count, executionMode == ExecutionMode::JIT_VERIFY);
+                scheduler.advance(1);
+                if (!result) {
+                    catchUp();
+                    caughtUpResult = 0;
+                    return 0;
+                }
+                return result | finishTick();
+            }
+        }
+    }
+#endif
+    ret_code result = FB_RET_SUCCESS;
+    ret_code cycleResult;
+    do {
+        cycleResult = cpu.doInstructionCycle(memory);
+        scheduler.advance(1);
+        if (!cycleResult) {
+            catchUp();
+            caughtUpResult = 0;
+            return 0;
+        }
+        result |= cycleResult;
+    } while (!(cycleResult & FB_RET_INSTRUCTION_DONE) && cpu.getState() == CPUState::RUNNING);
+    return result | finishTick();
+}
+
+ret_code Emulator::skipIdleLoop() {
+    if (!cpu.hasFetchedIdleLoop()) {
+        return 0;
+    }
+    // LY, STAT and the timers have to be up to date to compare them against the last iteration
+    catchUp();
+    const IdleLoop *loop = cpu.getIdleLoop(memory);
+    if (loop == nullptr) {
+        return 0;
+    }
+    // Whole iterations are skipped as long as each of them reads the same values and no interrupt can be requested
+    // before its last machine cycle. A value read in a machine cycle does not include the clocks of that cycle yet.
+    u32_fast clocks = ppu.getClocksUntilInterrupt(FB_MAX_SKIPPED_CYCLES * 4);
+    if (loop->readsSTAT) {
+        clocks = ppu.getClocksUntilSTATChange(clocks);
+    } else if (loop->readsLY) {
+        clocks = ppu.getClocksUntilLYChange(clocks);
+    }
+    u32_fast cycles = std::min<u32_fast>({
+            cpu.getUninterruptedCycles(FB_MAX_SKIPPED_CYCLES),
+            (clocks + 3) / 4,
+            static_cast<u32_fast>(std::min<u64>(FB_MAX_SKIPPED_CYCLES, getCyclesUntilLimit()))
+    });
+    cycles -= cycles % loop->cycles;
+    if (cycles == 0) {
+        return 0;
+    }
+    cpu.skipCycles(cycles);
+    skippedCycles += cycles;
+    scheduler.advance(cycles);
+    return finishTick();
+}
+
+bool Emulator::mayRequestInterrupt(u8_fast cycles) {
+    u64 until = scheduler.getCycles() + cycles;
+    return scheduler.getEventCycle(EventType::TIMER_INTERRUPT) <= until
+        || ppu.mayRequestInterrupt((until - syncedCycles) * 4);
+}
+
+void Emulator::catchUp() {
+    u32_fast pendingCycles = scheduler.getCycles() - syncedCycles;
+    if (pendingCycles == 0) {
+        return;
+    }
+    // Timers, PPU and APU only interact with each other by requesting interrupts, so they can be advanced
+    // one after the other instead of interleaving them per machine cycle
+    cpu.doTimers(memory, pendingCycles * 4);
+    caughtUpResult |= ppu.doClocks(cpu, pendingCycles * 4);
+#ifdef FB_USE_SOUND
+    apu.doTicks(pendingCycles);
+#endif
+    syncedCycles = scheduler.getCycles();
+}
+
+void Emulator::scheduleEvents() {
+    // Without any transition of the PPU or timer interrupt, everything is still caught up once per frame
+    scheduler.schedule(
+            EventType::PPU_TRANSITION,
+            syncedCycles + (ppu.getClocksUntilSTATChange(FB_MAX_SKIPPED_CYCLES * 4) + 3) / 4
+    );
+    scheduler.schedule(
+            EventType::TIMER_INTERRUPT,
+            syncedCycles + cpu.getCyclesUntilTimerInterrupt(FB_MAX_SKIPPED_CYCLES)
+    );
 #ifdef FB_USE_SOUND
-    apu.doTick();
+    scheduler.schedule(EventType::APU_FRAME_SEQUENCER, syncedCycles + apu.getTicksUntilFrameSequencerStep());
 #endif
+}
+
+ret_code Emulator::finishTick() {
+    if (scheduler.isEventDue()) {
+        catchUp();
 #ifdef FB_USE_AUTOSAVE
-    if (result & FB_RET_NEW_FRAME) {
-        if (memory.cartridgeRAMWritten) {
-            memory.cartridgeRAMWritten = false;
-            cramLastWritten = 0;
-        } else if (cramLastWritten != -1 && ++cramLastWritten >= 30) {
+        if (scheduler.isEventDue(EventType::AUTOSAVE)) {
+            scheduler.cancel(EventType::AUTOSAVE);
             doAutosave();
-            cramLastWritten = -1;
         }
-    }
 #endif
+        scheduleEvents();
+    }
+    ret_code result = caughtUpResult;
+    caughtUpResult = 0;
     return result;
 }
@@ -23,13 +23,25 @@
 #include <emulator/cpu.h>
 #include <emulator/ppu.h>
 #include <emulator/io_registers.h>
+#include <emulator/execution_mode.h>
+#include <emulator/stop_reason.h>
+#include <emulator/render_policy.h>
+#include <emulator/pixel_format.h>
+#include <emulator/frame_buffer.h>
+#include <emulator/scheduler.h>
+#include <emulator/machine_state.h>
+#include <emulator/rewind_buffer.h>
 #include <util/typedefs.h>
 #include <util/debug.h>
+#include <util/snapshot.h>
 #include <controllers/controllers.h>
 #include <memory/memory.h>
 #include <memory/ppu_memory.h>
 #include <memory>
 #include <iostream>
+#include <vector>
+#include <bitset>
+#include <limits>
 
 #ifdef FB_USE_SOUND
 #include <emulator/apu.h>
@@ -39,11 +51,58 @@ namespace FunkyBoy {
 
     class Emulator {
     private:
-#ifdef FB_USE_AUTOSAVE
-        int cramLastWritten;
+        // Has to be constructed before the components which refer into it
+        std::unique_ptr<MachineState> state;
+
+        const GameBoyType gbType;
+        Controller::ControllersPtr controllers;
 
+#ifdef FB_USE_AUTOSAVE
         void doAutosave();
 #endif
+
+        ExecutionMode executionMode;
+
+        Scheduler scheduler;
+        // Machine cycle up to which timers, PPU and APU have been advanced, as they lag behind the CPU
+        u64 syncedCycles;
+        ret_code caughtUpResult;
+
+        // Machine cycles which have been fast-forwarded in the current and in the last frame
+        u32_fast skippedCycles;
+        u32_fast lastFrameSkippedCycles;
+        // Machine cycle at which runUntil stops, beyond which a halted CPU or an idle loop is not fast-forwarded
+        u64 cycleLimit;
+
+        // Snapshots for rewinding, which are taken every rewindInterval frames
+        std::unique_ptr<RewindBuffer> rewindBuffer;
+        std::vector<u8> rewindSnapshot;
+        u32_fast rewindInterval;
+        u32_fast framesUntilRewindSnapshot;
+
+        std::bitset<0x10000> breakpoints;
+        size_t breakpointCount;
+
+        ret_code doMachineCycle();
+        ret_code doInstruction();
+        ret_code skipIdleLoop();
+        void catchUp();
+        // Schedules the next PPU transition, timer interrupt and frame sequencer step, which have to be caught up
+        void scheduleEvents();
+        // Catches up if an event is due and returns the result of everything that has been caught up during the tick
+        ret_code finishTick();
+        // Returns whether timers or PPU could request an interrupt within the given number of machine cycles from now
+        bool mayRequestInterrupt(u8_fast cycles);
+        inline u64 getCyclesUntilLimit() const {
+            return cycleLimit > scheduler.getCycles() ? cycleLimit - scheduler.getCycles() : 0;
+        }
+        CartridgeStatus finishLoadingGame();
+        // Everything but the memory controller and the cartridge, whose state depends on the loaded game
+        void writeSystemSnapshot(Snapshot::Writer &writer) const;
+        void readSystemSnapshot(Snapshot::Reader &reader);
+        void writeSnapshot(Snapshot::Writer &writer) const;
+        static const std::vector<u8> &getPowerUpSnapshot(GameBoyType gbType);
+        void captureRewindSnapshot();
     test_public:
         io_registers ioRegisters;
         PPUMemory ppuMemory;
@@ -60,10 +119,24 @@ namespace FunkyBoy {
 
         explicit Emulator(GameBoyType gbType);
 
+        Emulator(const Emulator &other) = delete;
+        Emulator &operator= (const Emulator &other) = delete;
+
+        // Creates an independent emulator at the same state, which shares the ROM image with this one and stops at the
+        // same breakpoints. Neither the buffer for rewinding nor the path for autosaving are taken over. The clone uses
+        // the given controllers, as controllers are not thread-safe and clones usually run in parallel to the original.
+        std::unique_ptr<Emulator> clone(const Controller::Controllers &controllers = Controller::Controllers()) const;
+
         void setControllers(const Controller::Controllers &controllers);
 
         CartridgeStatus loadGame(const fs::path &romPath);
         CartridgeStatus loadGame(std::istream &stream);
+        // Loads a ROM image, which may be shared with other emulators without being copied
+        CartridgeStatus loadGame(const ROMImagePtr &romImage);
+
+        // Resets the machine to its power-up state in place, without reloading the game or allocating memory. The
+        // cartridge RAM is cleared unless it is kept.
+        void reset(bool keepCartridgeRam);
 
         void loadCartridgeRam(std::istream &stream);
         void writeCartridgeRam(std::ostream &stream);
@@ -71,6 +144,26 @@ namespace FunkyBoy {
         void loadState(std::istream &istream);
         void saveState(std::ostream &ostream);
 
+        // Snapshots capture the complete machine state in a flat buffer, e.g. for rewinding. Unlike save states, they
+        // can only be restored by the same build with the same game loaded.
+        // Returns the size of a snapshot, which does not change as long as the same game is loaded
+        size_t getSnapshotSize() const;
+        void saveSnapshot(u8 *buffer, size_t size) const;
+        // Throws a ReadException without changing any state if the snapshot does not fit the loaded game
+        void loadSnapshot(const u8 *buffer, size_t size);
+
+        // Keeps a snapshot of every frameInterval-th frame in a buffer of the given size in bytes. Loading another game
+        // clears the buffer.
+        void enableRewind(size_t bufferSize, u32_fast frameInterval);
+        void disableRewind();
+        // Restores the newest snapshot which has been kept for rewinding and removes it. Returns false if there is none.
+        bool rewind();
+
+        // Returns nullptr if rewinding is disabled
+        inline const RewindBuffer *getRewindBuffer() const {
+            return rewindBuffer.get();
+        }
+
         inline void setInputState(Controller::JoypadKey key, bool pressed) {
             ioRegisters.setInputState(key, pressed);
         }
@@ -83,6 +176,11 @@ namespace FunkyBoy {
             return memory.getROMHeader();
         }
 
+        // Returns the image of the loaded ROM, or nullptr if none is loaded
+        inline const ROMImagePtr &getROMImage() const {
+            return memory.getROMImage();
+        }
+
         inline u8 *releaseROM(size_t *size) {
             return memory.releaseROM(size);
         }
@@ -95,7 +193,86 @@ namespace FunkyBoy {
             return memory.getCartridgeRamSize() > 0;
         }
 
+        void setExecutionMode(ExecutionMode mode);
+
+        inline ExecutionMode getExecutionMode() {
+            return executionMode;
+        }
+
+        // Limits the number of sprites on a line to 10 like the hardware does, which causes flickering in some games
+        inline void setSpriteLimitEnabled(bool enabled) {
+            ppu.setSpriteLimitEnabled(enabled);
+        }
+
+        inline bool isSpriteLimitEnabled() const {
+            return ppu.isSpriteLimitEnabled();
+        }
+
+        // Skipping frames saves the time spent on drawing them, e.g. if only some frames are looked at. The frame
+        // interval is only used by RENDER_EVERY_NTH_FRAME.
+        inline void setRenderPolicy(RenderPolicy policy, u32_fast frameInterval = 1) {
+            ppu.setRenderPolicy(policy, frameInterval);
+        }
+
+        inline RenderPolicy getRenderPolicy() const {
+            return ppu.getRenderPolicy();
+        }
+
+        // Draws the next frame which starts, if the render policy is RENDER_ON_REQUEST. A frame which has already
+        // started when this is called is not drawn.
+        inline void requestFrame() {
+            ppu.requestFrame();
+        }
+
+        // Frames are drawn in ARGB8888 by default
+        inline void setPixelFormat(PixelFormat format) {
+            ppu.getFrameBuffer().setPixelFormat(format);
+        }
+
+        inline PixelFormat getPixelFormat() const {
+            return ppu.getFrameBuffer().getPixelFormat();
+        }
+
+        // Sets the red, green and blue components of the 4 shades, which are not used by PIXEL_FORMAT_INDEXED
+        inline void setPalette(const u8 (&shades)[4][3]) {
+            ppu.getFrameBuffer().setPalette(shades);
+        }
+
+        // Returns the last frame which has been drawn, which may be partially overwritten by the current one
+        inline const FrameBuffer &getFrameBuffer() const {
+            return ppu.getFrameBuffer();
+        }
+
         ret_code doTick();
+
+        // Emulates until one of the conditions in the mask is met or at least the given number of machine cycles has
+        // passed, without returning after every tick. A halted CPU or an idle loop is never fast-forwarded beyond the
+        // given number of machine cycles, only the last instruction may exceed it.
+        StopReason runUntil(stop_mask stopMask, u64 maxCycles = std::numeric_limits<u64>::max());
+
+        inline StopReason runFrame() {
+            return runUntil(STOP_NEW_FRAME);
+        }
+
+        inline StopReason runCycles(u64 cycles) {
+            return runUntil(0, cycles);
+        }
+
+        // Returns the number of machine cycles which have been emulated since the emulator has been powered up
+        inline u64 getMachineCycles() const {
+            return scheduler.getCycles();
+        }
+
+        // runUntil stops before an instruction at a breakpoint is executed. As long as breakpoints are set, compiled
+        // blocks and idle loops are not used, so that no instruction is passed over.
+        void setBreakpoint(memory_address address, bool enabled);
+        void clearBreakpoints();
+
+        // Returns the number of machine cycles of the last frame which have been fast-forwarded while the CPU was
+        // halted or in an idle loop
+        inline u32_fast getLastFrameSkippedCycles() const {
+            return lastFrameSkippedCycles;
+        }
     };
 
 }
@@ -0,0 +1,46 @@
+/**
+ * Copyright 2021 Michel Kremer (kremi151)
+ *
+ * Licensed under the Apache License, Version 2.0 (the License);
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef FB_CORE_EXECUTION_MODE_H
+#define FB_CORE_EXECUTION_MODE_H
+
+namespace FunkyBoy {
+
+    enum ExecutionMode {
+        // Every call to Emulator::doTick() advances the whole machine by one machine cycle. While the CPU is halted,
+        // a single call fast-forwards up to the next machine cycle in which an interrupt could be requested, which is
+        // at most one frame (17556 machine cycles) ahead.
+        MACHINE_CYCLE = 0,
+
+        // Every call to Emulator::doTick() runs a complete instruction. Timers, PPU and APU are caught up
+        // afterwards, or earlier if the instruction accesses memory which is driven by them.
+        INSTRUCTION = 1,
+
+#ifdef FB_USE_JIT
+        // Same as INSTRUCTION, but hot blocks in ROM are translated to native code and executed at once, as long as
+        // no interrupt can be requested in between
+        JIT = 2,
+
+        // Same as JIT, but every compiled block is verified against the interpreter. Emulator::doTick() fails as soon
+        // as both results differ.
+        JIT_VERIFY = 3,
+#endif
+    };
+
+}
+
+#endif //FB_CORE_EXECUTION_MODE_H
@@ -0,0 +1,104 @@
+/**
+ * Copyright 2021 Michel Kremer (kremi151)
+ *
+ * Licensed under the Apache License, Version 2.0 (the License);
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "frame_buffer.h"
+
+#include <emulator/scanline_compositor.h>
+#include <palette/dmg_palette.h>
+
+#include <cstring>
+
+using namespace FunkyBoy;
+
+FrameBuffer::FrameBuffer()
+    : format(PixelFormat::PIXEL_FORMAT_ARGB8888)
+    , palette{}
+    , colors{}
+    , pixels(new u32[FB_GB_DISPLAY_WIDTH * FB_GB_DISPLAY_HEIGHT]{})
+{
+    setPalette(Palette::ARGB8888::DMG);
+}
+
+void FrameBuffer::setPixelFormat(PixelFormat pixelFormat) {
+    format = pixelFormat;
+    updateColors();
+}
+
+void FrameBuffer::setPalette(const u8 (&shades)[4][3]) {
+    std::memcpy(palette, shades, sizeof(palette));
+    updateColors();
+}
+
+void FrameBuffer::updateColors() {
+    for (u8 shade = 0 ; shade < 4 ; shade++) {
+        const u32 red = palette[shade][0];
+        const u32 green = palette[shade][1];
+        const u32 blue = palette[shade][2];
+        switch (format) {
+            case PixelFormat::PIXEL_FORMAT_ARGB8888:
+                colors[shade] = (255u << 24u) | (red << 16u) | (green << 8u) | blue;
+                break;
+            case PixelFormat::PIXEL_FORMAT_RGB565:
+                colors[shade] = ((red >> 3u) << 11u) | ((green >> 2u) << 5u) | (blue >> 3u);
+                break;
+            case PixelFormat::PIXEL_FORMAT_RGBA5551:
+                colors[shade] = ((red >> 3u) << 11u) | ((green >> 3u) << 6u) | ((blue >> 3u) << 1u) | 1u;
+                break;
+            default:
+                colors[shade] = shade;
+                break;
+        }
+    }
+}
+
+size_t FrameBuffer::getPitch() const {
+    switch (format) {
+        case PixelFormat::PIXEL_FORMAT_ARGB8888:
+            return FB_GB_DISPLAY_WIDTH * sizeof(u32);
+        case PixelFormat::PIXEL_FORMAT_RGB565:
+        case PixelFormat::PIXEL_FORMAT_RGBA5551:
+            return FB_GB_DISPLAY_WIDTH * sizeof(u16);
+        default:
+            return FB_GB_DISPLAY_WIDTH;
+    }
+}
+
+void FrameBuffer::drawLine(u8 y, const u8 *shades) {
+    u8 *line = reinterpret_cast<u8 *>(pixels.get()) + y * getPitch();
+    switch (format) {
+        case PixelFormat::PIXEL_FORMAT_ARGB8888:
+            Compositor::applyColors(reinterpret_cast<u32 *>(line), shades, FB_GB_DISPLAY_WIDTH, colors);
+            break;
+        case PixelFormat::PIXEL_FORMAT_RGB565:
+        case PixelFormat::PIXEL_FORMAT_RGBA5551:
+            Compositor::applyColors(reinterpret_cast<u16 *>(line), shades, FB_GB_DISPLAY_WIDTH, colors);
+            break;
+        default:
+            std::memcpy(line, shades, FB_GB_DISPLAY_WIDTH);
+            break;
+    }
+}
+
+void FrameBuffer::copyFrom(const FrameBuffer &other) {
+    format = other.format;
+    std::memcpy(palette, other.palette, sizeof(palette));
+    std::memcpy(colors, other.colors, sizeof(colors));
+    std::memcpy(pixels.get(), other.pixels.get(), FB_GB_DISPLAY_WIDTH * FB_GB_DISPLAY_HEIGHT * sizeof(u32));
+}
+
+void FrameBuffer::clear() {
+    std::memset(pixels.get(), 0, FB_GB_DISPLAY_WIDTH * FB_GB_DISPLAY_HEIGHT * sizeof(u32));
+}
@@ -0,0 +1,81 @@
+/**
+ * Copyright 2021 Michel Kremer (kremi151)
+ *
+ * Licensed under the Apache License, Version 2.0 (the License);
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FB_CORE_FRAME_BUFFER_H
+#define FB_CORE_FRAME_BUFFER_H
+
+#include <emulator/pixel_format.h>
+#include <util/typedefs.h>
+
+#include <cstddef>
+#include <memory>
+
+namespace FunkyBoy {
+
+    /**
+     * Pixels of the screen, which the PPU writes line by line in the selected pixel format. Shades are converted through
+     * a table of 4 colors, which is built whenever the format or the palette changes.
+     */
+    class FrameBuffer {
+    private:
+        PixelFormat format;
+        u8 palette[4][3];
+        // Colors of the 4 shades in the selected format
+        u32 colors[4];
+        // Large enough for every format
+        std::unique_ptr<u32[]> pixels;
+
+        void updateColors();
+
+    public:
+        FrameBuffer();
+
+        FrameBuffer(const FrameBuffer &other) = delete;
+        FrameBuffer &operator= (const FrameBuffer &other) = delete;
+
+        // Pixels which have been drawn before are not converted
+        void setPixelFormat(PixelFormat pixelFormat);
+
+        inline PixelFormat getPixelFormat() const {
+            return format;
+        }
+
+        // Sets the red, green and blue components of the 4 shades, which are Palette::ARGB8888::DMG by default
+        void setPalette(const u8 (&shades)[4][3]);
+
+        inline const u8 (&getPalette() const)[4][3] {
+            return palette;
+        }
+
+        inline const void *getPixels() const {
+            return pixels.get();
+        }
+
+        // Returns the number of bytes per line
+        size_t getPitch() const;
+
+        void drawLine(u8 y, const u8 *shades);
+
+        // Takes over the format, the palette and the pixels of the other frame buffer
+        void copyFrom(const FrameBuffer &other);
+
+        // Sets all bytes to 0
+        void clear();
+    };
+
+}
+
+#endif //FB_CORE_FRAME_BUFFER_H
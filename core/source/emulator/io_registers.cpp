@@ -20,42 +20,36 @@
 
 using namespace FunkyBoy;
 
-#define FB_HW_IO_BYTES 128
-
 io_registers::io_registers(const io_registers &registers)
-    : sys_counter(registers.sys_counter)
-    , hwIO(registers.hwIO)
-    , inputsDPad(registers.inputsDPad)
-    , inputsButtons(registers.inputsButtons)
-    , inputsChanged(registers.inputsChanged)
-    , ptrCounter(registers.ptrCounter)
+    : ptrCounter(registers.ptrCounter)
+    , state(registers.state)
 {
-    (*ptrCounter)++;
+    if (ptrCounter != nullptr) {
+        (*ptrCounter)++;
+    }
 }
 
 io_registers::io_registers()
-    : sys_counter(new u16(0))
-    , hwIO(new u8[FB_HW_IO_BYTES]{})
-    , inputsDPad(new u8_fast(0b11111111u))
-    , inputsButtons(new u8_fast(0b11111111u))
-    , inputsChanged(new bool(false))
-    , ptrCounter(new u16(1))
+    : ptrCounter(new u16(1))
+    , state(new IORegistersState())
+{
+}
+
+io_registers::io_registers(IORegistersState &state)
+    : ptrCounter(nullptr)
+    , state(&state)
 {
 }
 
 io_registers::~io_registers() {
-    if (--(*ptrCounter) < 1) {
-        delete sys_counter;
-        delete[] hwIO;
-        delete inputsDPad;
-        delete inputsButtons;
-        delete inputsChanged;
+    if (ptrCounter != nullptr && --(*ptrCounter) < 1) {
+        delete state;
         delete ptrCounter;
     }
 }
 
 void io_registers::resetSysCounter() {
-    *sys_counter = 0;
+    state->sysCounter = 0;
 }
 
 void io_registers::handleMemoryWrite(u8 offset, u8 value) {
@@ -67,21 +61,21 @@ void io_registers::handleMemoryWrite(u8 offset, u8 value) {
         }
         case __FB_REG_OFFSET_P1: {
             // Only bits 4 and 5 are writable
-            u8 currentP1 = *(hwIO + __FB_REG_OFFSET_P1) & 0b00001111u;
+            u8 currentP1 = *(state->hwIO + __FB_REG_OFFSET_P1) & 0b00001111u;
             value = (value & 0b00110000u) // Keep the two writable bits (Bits 6 and 7 always read '1' and are set to '1' by calculateP1Value)
                   | currentP1;            // Take the read-only bits from the current P1 value
-            *(hwIO + __FB_REG_OFFSET_P1) = calculateP1Value(value);
+            *(state->hwIO + __FB_REG_OFFSET_P1) = calculateP1Value(value);
             break;
         }
         case __FB_REG_OFFSET_STAT: {
             // Only bits 3-6 are writable, bit 7 reads always '1'
             value = (value & 0b01111000u) | 0b10000000u;
-            value |= *(hwIO + __FB_REG_OFFSET_STAT) & 0b00000111u;
-            *(hwIO + __FB_REG_OFFSET_STAT) = value;
+            value |= *(state->hwIO + __FB_REG_OFFSET_STAT) & 0b00000111u;
+            *(state->hwIO + __FB_REG_OFFSET_STAT) = value;
             break;
         }
         default: {
-            *(hwIO + offset) = value;
+            *(state->hwIO + offset) = value;
             break;
         }
     }
@@ -90,15 +84,15 @@ void io_registers::handleMemoryWrite(u8 offset, u8 value) {
 u8 io_registers::handleMemoryRead(u8 offset) {
     switch (offset) {
         case __FB_REG_OFFSET_DIV:
-            return *sys_counter >> 8;
+            return state->sysCounter >> 8;
         default:
-            return *(hwIO + offset);
+            return *(state->hwIO + offset);
     }
 }
 
 void io_registers::setInputState(Controller::JoypadKey key, bool pressed) {
-    u8_fast nextInputsButtons = *inputsButtons;
-    u8_fast nextInputsDPad = *inputsDPad;
+    u8_fast nextInputsButtons = state->inputsButtons;
+    u8_fast nextInputsDPad = state->inputsDPad;
     switch (key) {
         case Controller::JoypadKey::JOYPAD_A:
             if (pressed) {
@@ -157,10 +151,10 @@ void io_registers::setInputState(Controller::JoypadKey key, bool pressed) {
             }
             break;
     }
-    if (nextInputsButtons != *inputsButtons || nextInputsDPad != *inputsDPad) {
-        *inputsButtons = nextInputsButtons;
-        *inputsDPad = nextInputsDPad;
-        *inputsChanged = true;
+    if (nextInputsButtons != state->inputsButtons || nextInputsDPad != state->inputsDPad) {
+        state->inputsButtons = nextInputsButtons;
+        state->inputsDPad = nextInputsDPad;
+        state->inputsChanged = true;
         updateJoypad();
     }
 }
@@ -169,25 +163,25 @@ u8_fast io_registers::calculateP1Value(u8_fast inP1) {
     u8_fast val = inP1 | 0b11001111u;
     if ((inP1 & 0b00100000u) == 0) {
         // Select Button keys
-        val &= *inputsButtons;
+        val &= state->inputsButtons;
     }
     if ((inP1 & 0b00010000u) == 0) {
         // Select Direction keys
-        val &= *inputsDPad;
+        val &= state->inputsDPad;
     }
     return val;
 }
 
 void io_registers::serialize(std::ostream &ostream) const {
-    ostream.write(reinterpret_cast<const char*>(hwIO), FB_HW_IO_BYTES);
-    ostream.put(*inputsDPad & 0xffu);
-    ostream.put(*inputsButtons & 0xffu);
-    ostream.put(*inputsChanged);
-    Util::Stream::write16Bits(*sys_counter, ostream);
+    ostream.write(reinterpret_cast<const char*>(state->hwIO), FB_HW_IO_BYTES);
+    ostream.put(state->inputsDPad & 0xffu);
+    ostream.put(state->inputsButtons & 0xffu);
+    ostream.put(state->inputsChanged);
+    Util::Stream::write16Bits(state->sysCounter, ostream);
 }
 
 void io_registers::deserialize(std::istream &istream) {
-    istream.read(reinterpret_cast<char*>(hwIO), FB_HW_IO_BYTES);
+    istream.read(reinterpret_cast<char*>(state->hwIO), FB_HW_IO_BYTES);
     if (!istream) {
         throw Exception::ReadException("Stream is too short (HWIO)");
     }
@@ -197,8 +191,8 @@ void io_registers::deserialize(std::istream &istream) {
     if (!istream) {
         throw Exception::ReadException("Stream is too short (IO registers)");
     }
-    *inputsDPad = buffer[0];
-    *inputsButtons = buffer[1];
-    *inputsChanged = buffer[2];
-    *sys_counter = Util::Stream::read16Bits(istream);
+    state->inputsDPad = buffer[0];
+    state->inputsButtons = buffer[1];
+    state->inputsChanged = buffer[2];
+    state->sysCounter = Util::Stream::read16Bits(istream);
 }
\ No newline at end of file
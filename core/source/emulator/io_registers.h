@@ -67,6 +67,8 @@
 #define FB_REG_WX 0xFF4B
 #define FB_REG_IE 0xFFFF
 
+#define FB_HW_IO_BYTES 128
+
 #define FB_REG_WAVE_RAM_START 0xFF30
 #define __FB_REG_OFFSET_WAVE_RAM_START (FB_REG_WAVE_RAM_START - 0xFF00)
 
@@ -90,10 +92,10 @@
 
 #define __FB_REG_GETTER(name, offset) \
 inline u8 &get ## name () { \
-    return *(hwIO + offset - 0xFF00); \
+    return *(state->hwIO + offset - 0xFF00); \
 } \
 inline u8 get ## name () const { \
-    return *(hwIO + offset - 0xFF00); \
+    return *(state->hwIO + offset - 0xFF00); \
 }
 
 namespace FunkyBoy {
@@ -101,30 +103,36 @@ namespace FunkyBoy {
     /* Forward declaration */
     class CPU;
 
+    struct IORegistersState {
+        u8 hwIO[FB_HW_IO_BYTES]{};
+        u16 sysCounter = 0;
+        u8_fast inputsDPad = 0b11111111u;
+        u8_fast inputsButtons = 0b11111111u;
+        bool inputsChanged = false;
+    };
+
     class io_registers {
     private:
+        // Shared by all copies, only set if the state is owned by them
         u16 *ptrCounter;
-        u8 *hwIO;
         void resetSysCounter();
 
         u8_fast calculateP1Value(u8_fast inP1);
-
-        u8_fast *inputsDPad;
-        u8_fast *inputsButtons;
-        bool *inputsChanged;
     test_public:
-        u16 *sys_counter;
+        IORegistersState *state;
     public:
         io_registers(const io_registers &registers);
         io_registers();
+        // Uses state which is owned by the caller
+        explicit io_registers(IORegistersState &state);
         ~io_registers();
 
         inline u16 &getSysCounter() {
-            return *sys_counter;
+            return state->sysCounter;
         }
 
         inline void setSysCounter(u16 counter) {
-            *sys_counter = counter;
+            state->sysCounter = counter;
         }
 
         void handleMemoryWrite(u8 offset, u8 value);
@@ -133,87 +141,91 @@ namespace FunkyBoy {
         void setInputState(Controller::JoypadKey key, bool pressed);
 
         inline void updateJoypad() {
-            *(hwIO + __FB_REG_OFFSET_P1) = calculateP1Value(*(hwIO + __FB_REG_OFFSET_P1));
+            *(state->hwIO + __FB_REG_OFFSET_P1) = calculateP1Value(*(state->hwIO + __FB_REG_OFFSET_P1));
+        }
+
+        inline bool haveInputsChanged() const {
+            return state->inputsChanged;
         }
 
         inline bool clearInputsChanged() {
-            if (*inputsChanged) {
-                *inputsChanged = false;
+            if (state->inputsChanged) {
+                state->inputsChanged = false;
                 return true;
             }
             return false;
         }
 
         inline u8 *getWaveRAM() {
-            return hwIO + __FB_REG_OFFSET_WAVE_RAM_START;
+            return state->hwIO + __FB_REG_OFFSET_WAVE_RAM_START;
         }
 
         inline u8 &getP1() {
-            return *(hwIO + __FB_REG_OFFSET_P1);
+            return *(state->hwIO + __FB_REG_OFFSET_P1);
         }
 
         inline u8_fast getDIV() {
-            return *sys_counter >> 8;
+            return state->sysCounter >> 8;
         }
 
         inline u8 &getTIMA() {
-            return *(hwIO + __FB_REG_OFFSET_TIMA);
+            return *(state->hwIO + __FB_REG_OFFSET_TIMA);
         }
 
         inline u8 &getTMA() {
-            return *(hwIO + __FB_REG_OFFSET_TMA);
+            return *(state->hwIO + __FB_REG_OFFSET_TMA);
         }
 
         inline u8 &getTAC() {
-            return *(hwIO + __FB_REG_OFFSET_TAC);
+            return *(state->hwIO + __FB_REG_OFFSET_TAC);
         }
 
         inline u8 &getIF() {
-            return *(hwIO + __FB_REG_OFFSET_IF);
+            return *(state->hwIO + __FB_REG_OFFSET_IF);
         }
 
         inline u8 &getLCDC() {
-            return *(hwIO + __FB_REG_OFFSET_LCDC);
+            return *(state->hwIO + __FB_REG_OFFSET_LCDC);
         }
 
         inline u8 &getSTAT() {
-            return *(hwIO + __FB_REG_OFFSET_STAT);
+            return *(state->hwIO + __FB_REG_OFFSET_STAT);
         }
 
         inline u8 &getSCX() {
-            return *(hwIO + __FB_REG_OFFSET_SCX);
+            return *(state->hwIO + __FB_REG_OFFSET_SCX);
         }
 
         inline u8 &getSCY() {
-            return *(hwIO + __FB_REG_OFFSET_SCY);
+            return *(state->hwIO + __FB_REG_OFFSET_SCY);
         }
 
         inline u8 &getLY() {
-            return *(hwIO + __FB_REG_OFFSET_LY);
+            return *(state->hwIO + __FB_REG_OFFSET_LY);
         }
 
         inline u8 &getLYC() {
-            return *(hwIO + __FB_REG_OFFSET_LYC);
+            return *(state->hwIO + __FB_REG_OFFSET_LYC);
         }
 
         inline u8 &getBGP() {
-            return *(hwIO + __FB_REG_OFFSET_BGP);
+            return *(state->hwIO + __FB_REG_OFFSET_BGP);
         }
 
         inline u8 &getOBP0() {
-            return *(hwIO + __FB_REG_OFFSET_OBP0);
+            return *(state->hwIO + __FB_REG_OFFSET_OBP0);
         }
 
         inline u8 &getOBP1() {
-            return *(hwIO + __FB_REG_OFFSET_OBP1);
+            return *(state->hwIO + __FB_REG_OFFSET_OBP1);
         }
 
         inline u8 &getWX() {
-            return *(hwIO + __FB_REG_OFFSET_WX);
+            return *(state->hwIO + __FB_REG_OFFSET_WX);
         }
 
         inline u8 &getWY() {
-            return *(hwIO + __FB_REG_OFFSET_WY);
+            return *(state->hwIO + __FB_REG_OFFSET_WY);
         }
 
         __FB_REG_GETTER(NR10, FB_REG_NR10)
@@ -0,0 +1,414 @@
+/**
+ * Copyright 2021 Michel Kremer (kremi151)
+ *
+ * Licensed under the Apache License, Version 2.0 (the License);
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "jit.h"
+
+#ifdef FB_USE_JIT
+
+#include <operands/tables.h>
+#include <sys/mman.h>
+#include <cstring>
+#include <initializer_list>
+
+#define FB_JIT_SLOTS 1024
+#define FB_JIT_HOT_THRESHOLD 16
+#define FB_JIT_MIN_INSTRUCTIONS 2
+#define FB_JIT_MAX_INSTRUCTIONS 32
+#define FB_JIT_CODE_BUFFER_SIZE 0x10000
+#define FB_JIT_NO_KEY 0xffffffffu
+
+#define FB_JIT_REG_F 6
+#define FB_JIT_REG_A 7
+
+using namespace FunkyBoy;
+
+namespace FunkyBoy {
+
+    // Maps the x86 flags loaded into AH by LAHF (SF ZF 0 AF 0 PF 1 CF) to the Z, H and C flags of register F
+    struct FlagTable {
+        u8 values[256]{};
+
+        FlagTable() {
+            for (unsigned ah = 0 ; ah < 256 ; ah++) {
+                values[ah] = ((ah & 0x40u) << 1) | ((ah & 0x10u) << 1) | ((ah & 0x01u) << 4);
+            }
+        }
+    };
+
+    const FlagTable flagTable;
+
+    // Opcodes of ADD, ADC, SUB, SBB, AND, XOR, OR and CMP in the same order as the ALU instructions of the Game Boy
+    const u8 aluRegisterOpcodes[8] = {0x02, 0x12, 0x2a, 0x1a, 0x22, 0x32, 0x0a, 0x3a};
+    const u8 aluImmediateOpcodes[8] = {0x04, 0x14, 0x2c, 0x1c, 0x24, 0x34, 0x0c, 0x3c};
+
+    /**
+     * Emits x86-64 code for the System V calling convention. The registers array is passed in RDI and the number of
+     * instructions to run in R8D, RSI holds the flag table, and only RAX, RCX and RDX are used as scratch registers.
+     */
+    class Assembler {
+    private:
+        std::vector<u8> &code;
+
+        inline void emit(std::initializer_list<u8> bytes) {
+            code.insert(code.end(), bytes);
+        }
+
+        // Converts the x86 flags of the last operation into register F
+        void storeFlags(u8 mask, u8 set, bool keepCarry) {
+            emit({0x9f}); // lahf
+            emit({0x0f, 0xb6, 0xcc}); // movzx ecx, ah
+            emit({0x8a, 0x0c, 0x0e}); // mov cl, [rsi+rcx]
+            if (mask != 0xff) {
+                emit({0x80, 0xe1, mask}); // and cl, mask
+            }
+            if (set) {
+                emit({0x80, 0xc9, set}); // or cl, set
+            }
+            if (keepCarry) {
+                emit({0x8a, 0x57, FB_JIT_REG_F}); // mov dl, [rdi+F]
+                emit({0x80, 0xe2, 0x10}); // and dl, 0x10
+                emit({0x08, 0xd1}); // or cl, dl
+            }
+            emit({0x88, 0x4f, FB_JIT_REG_F}); // mov [rdi+F], cl
+        }
+
+    public:
+        explicit Assembler(std::vector<u8> &code): code(code) {
+        }
+
+        void prologue() {
+            emit({0x41, 0x89, 0xf0}); // mov r8d, esi
+            auto table = reinterpret_cast<u64>(flagTable.values);
+            emit({0x48, 0xbe}); // mov rsi, imm64
+            for (u8 i = 0 ; i < 8 ; i++) {
+                code.push_back((table >> (i * 8)) & 0xffu);
+            }
+        }
+
+        void ret() {
+            emit({0xc3});
+        }
+
+        // Returns unless more than index instructions have been requested
+        void exitUnlessCount(u8 index) {
+            emit({0x41, 0x83, 0xf8, index}); // cmp r8d, index
+            emit({0x77, 0x01}); // ja +1
+            ret();
+        }
+
+        void load(u8 dst, u8 src) {
+            if (dst != src) {
+                emit({0x8a, 0x47, src}); // mov al, [rdi+src]
+                emit({0x88, 0x47, dst}); // mov [rdi+dst], al
+            }
+        }
+
+        void loadImmediate(u8 dst, u8 val) {
+            emit({0xc6, 0x47, dst, val}); // mov byte [rdi+dst], val
+        }
+
+        void incDec(u8 reg, bool dec) {
+            emit({0x8a, 0x47, reg}); // mov al, [rdi+reg]
+            emit({0xfe, static_cast<u8>(dec ? 0xc8 : 0xc0)}); // dec al / inc al
+            emit({0x88, 0x47, reg}); // mov [rdi+reg], al
+            storeFlags(0b10100000u, dec ? 0b01000000u : 0, true);
+        }
+
+        void incDec16(u8 regHigh, bool dec) {
+            // Register pairs are stored in big endian order
+            emit({0x0f, 0xb7, 0x47, regHigh}); // movzx eax, word [rdi+regHigh]
+            emit({0x66, 0xc1, 0xc0, 0x08}); // rol ax, 8
+            emit({0x66, 0xff, static_cast<u8>(dec ? 0xc8 : 0xc0)}); // dec ax / inc ax
+            emit({0x66, 0xc1, 0xc0, 0x08}); // rol ax, 8
+            emit({0x66, 0x89, 0x47, regHigh}); // mov [rdi+regHigh], ax
+        }
+
+        // op is the index of the ALU operation as encoded in bits 3-5 of the Game Boy opcode
+        void alu(u8 op, bool immediate, u8 operand) {
+            emit({0x8a, 0x47, FB_JIT_REG_A}); // mov al, [rdi+A]
+            if (op == 1 || op == 3) {
+                // Shift the carry flag of register F into the x86 carry flag for ADC and SBB
+                emit({0x8a, 0x4f, FB_JIT_REG_F}); // mov cl, [rdi+F]
+                emit({0xc0, 0xe9, 0x05}); // shr cl, 5
+            }
+            if (immediate) {
+                emit({aluImmediateOpcodes[op], operand}); // op al, operand
+            } else {
+                emit({aluRegisterOpcodes[op], 0x47, operand}); // op al, [rdi+operand]
+            }
+            if (op != 7) {
+                emit({0x88, 0x47, FB_JIT_REG_A}); // mov [rdi+A], al
+            }
+            switch (op) {
+                case 0:
+                case 1:
+                    storeFlags(0xff, 0, false);
+                    break;
+                case 2:
+                case 3:
+                case 7:
+                    storeFlags(0xff, 0b01000000u, false);
+                    break;
+                case 4:
+                    // The x86 half carry flag is undefined after logical operations
+                    storeFlags(0b10000000u, 0b00100000u, false);
+                    break;
+                default:
+                    storeFlags(0b10000000u, 0, false);
+                    break;
+            }
+        }
+
+        void cpl() {
+            emit({0xf6, 0x57, FB_JIT_REG_A}); // not byte [rdi+A]
+            emit({0x80, 0x4f, FB_JIT_REG_F, 0b01100000u}); // or byte [rdi+F], NH
+        }
+
+        void scf() {
+            emit({0x80, 0x67, FB_JIT_REG_F, 0b10000000u}); // and byte [rdi+F], Z
+            emit({0x80, 0x4f, FB_JIT_REG_F, 0b00010000u}); // or byte [rdi+F], C
+        }
+
+        void ccf() {
+            emit({0x80, 0x67, FB_JIT_REG_F, 0b10010000u}); // and byte [rdi+F], ZC
+            emit({0x80, 0x77, FB_JIT_REG_F, 0b00010000u}); // xor byte [rdi+F], C
+        }
+    };
+
+    // Returns the length in bytes of an instruction which can be compiled, or 0 if it has to be interpreted
+    u8 getCompiledLength(u8 opcode) {
+        switch (opcode) {
+            case 0x00: // NOP
+            case 0x03: // INC BC
+            case 0x0B: // DEC BC
+            case 0x13: // INC DE
+            case 0x1B: // DEC DE
+            case 0x23: // INC HL
+            case 0x2B: // DEC HL
+            case 0x2F: // CPL
+            case 0x37: // SCF
+            case 0x3F: // CCF
+                return 1;
+            case 0x01: // LD BC,u16
+            case 0x11: // LD DE,u16
+            case 0x21: // LD HL,u16
+                return 3;
+            default:
+                break;
+        }
+        u8 dst = opcode >> 3u & 7u;
+        u8 src = opcode & 7u;
+        if (opcode < 0x40) {
+            if (dst == 6) {
+                return 0;
+            }
+            switch (src) {
+                case 4: // INC r
+                case 5: // DEC r
+                    return 1;
+                case 6: // LD r,u8
+                    return 2;
+                default:
+                    return 0;
+            }
+        } else if (opcode < 0xC0) {
+            // LD r,r' or ALU A,r, but not the variants accessing (HL), which includes HALT
+            return src == 6 || (opcode < 0x80 && dst == 6) ? 0 : 1;
+        } else {
+            // ALU A,u8
+            return src == 6 ? 2 : 0;
+        }
+    }
+
+    void emitInstruction(Assembler &assembler, const CompiledInstruction &instruction) {
+        u8 opcode = instruction.opcode;
+        u8 dst = opcode >> 3u & 7u;
+        u8 src = opcode & 7u;
+        if (opcode >= 0xC0) {
+            assembler.alu(dst, true, instruction.immediates[0]);
+        } else if (opcode >= 0x80) {
+            assembler.alu(dst, false, src);
+        } else if (opcode >= 0x40) {
+            assembler.load(dst, src);
+        } else {
+            switch (opcode) {
+                case 0x00:
+                    break;
+                case 0x01:
+                case 0x11:
+                case 0x21:
+                    assembler.loadImmediate(opcode >> 4u << 1u, instruction.immediates[1]);
+                    assembler.loadImmediate((opcode >> 4u << 1u) + 1, instruction.immediates[0]);
+                    break;
+                case 0x03:
+                case 0x13:
+                case 0x23:
+                    assembler.incDec16(opcode >> 4u << 1u, false);
+                    break;
+                case 0x0B:
+                case 0x1B:
+                case 0x2B:
+                    assembler.incDec16(opcode >> 4u << 1u, true);
+                    break;
+                case 0x2F:
+                    assembler.cpl();
+                    break;
+                case 0x37:
+                    assembler.scf();
+                    break;
+                case 0x3F:
+                    assembler.ccf();
+                    break;
+                default:
+                    if (src == 6) {
+                        assembler.loadImmediate(dst, instruction.immediates[0]);
+                    } else {
+                        assembler.incDec(dst, src == 5);
+                    }
+                    break;
+            }
+        }
+    }
+
+}
+
+JIT::JIT()
+    : slots(FB_JIT_SLOTS, Slot{FB_JIT_NO_KEY, 0, nullptr})
+    , codeBufferUsed(0)
+    , romVersion(0)
+{
+}
+
+JIT::~JIT() {
+    clear();
+}
+
+const CompiledBlock *JIT::enterBlock(Memory &memory, memory_address address, u32 key) {
+    if (romVersion != memory.getROMVersion()) {
+        clear();
+        romVersion = memory.getROMVersion();
+    }
+    Slot &slot = slots[address & (FB_JIT_SLOTS - 1)];
+    if (slot.key != key) {
+        auto it = blocks.find(key);
+        slot.key = key;
+        slot.hits = 0;
+        slot.block = it != blocks.end() ? &it->second : nullptr;
+    }
+    if (slot.block == nullptr) {
+        if (++slot.hits < FB_JIT_HOT_THRESHOLD) {
+            return nullptr;
+        }
+        slot.block = compile(memory, address, key);
+    }
+    return slot.block->code != nullptr ? slot.block : nullptr;
+}
+
+const CompiledBlock *JIT::compile(Memory &memory, memory_address address, u32 key) {
+    CompiledBlock &block = blocks[key];
+    block.code = nullptr;
+
+    std::vector<u8> code;
+    Assembler assembler(code);
+    assembler.prologue();
+
+    memory_address pc = address;
+    u8 cycles = 0;
+    i16 lsb = -1;
+    i16 msb = -1;
+    while (block.instructions.size() < FB_JIT_MAX_INSTRUCTIONS) {
+        CompiledInstruction instruction{};
+        instruction.opcode = memory.read8BitsAt(pc);
+        u8 length = getCompiledLength(instruction.opcode);
+        // A block must not leave the ROM bank it has been looked up in
+        if (length == 0 || ((pc + length - 1) ^ address) & 0xc000u) {
+            break;
+        }
+        for (u8 i = 1 ; i < length && i <= sizeof(instruction.immediates) ; i++) {
+            instruction.immediates[i - 1] = memory.read8BitsAt(pc + i);
+        }
+        if (length > 1) {
+            lsb = instruction.immediates[0];
+        }
+        if (length > 2) {
+            msb = instruction.immediates[1];
+        }
+        instruction.operands = Operands::Tables::instructions[instruction.opcode];
+        for (auto op = instruction.operands ; *op != nullptr ; op++) {
+            cycles++;
+        }
+        pc += length;
+
+        instruction.cycles = cycles;
+        instruction.length = pc - address;
+        instruction.lsb = lsb;
+        instruction.msb = msb;
+
+        if (!block.instructions.empty()) {
+            assembler.exitUnlessCount(block.instructions.size());
+        }
+        emitInstruction(assembler, instruction);
+        block.instructions.push_back(instruction);
+    }
+
+    if (block.instructions.size() >= FB_JIT_MIN_INSTRUCTIONS) {
+        assembler.ret();
+        block.code = install(code);
+    }
+    if (block.code == nullptr) {
+        block.instructions.clear();
+        block.instructions.shrink_to_fit();
+    }
+    return &block;
+}
+
+NativeBlock JIT::install(const std::vector<u8> &code) {
+    if (codeBuffers.empty() || codeBufferUsed + code.size() > FB_JIT_CODE_BUFFER_SIZE) {
+        void *buffer = mmap(nullptr, FB_JIT_CODE_BUFFER_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (buffer == MAP_FAILED) {
+            return nullptr;
+        }
+        codeBuffers.push_back(static_cast<u8*>(buffer));
+        codeBufferUsed = 0;
+    }
+    u8 *buffer = codeBuffers.back();
+    // Code buffers are never writable and executable at the same time
+    if (mprotect(buffer, FB_JIT_CODE_BUFFER_SIZE, PROT_READ | PROT_WRITE) != 0) {
+        return nullptr;
+    }
+    std::memcpy(buffer + codeBufferUsed, code.data(), code.size());
+    if (mprotect(buffer, FB_JIT_CODE_BUFFER_SIZE, PROT_READ | PROT_EXEC) != 0) {
+        return nullptr;
+    }
+    auto block = reinterpret_cast<NativeBlock>(buffer + codeBufferUsed);
+    codeBufferUsed += (code.size() + 15) & ~static_cast<size_t>(15);
+    return block;
+}
+
+void JIT::clear() {
+    blocks.clear();
+    for (auto &slot : slots) {
+        slot = Slot{FB_JIT_NO_KEY, 0, nullptr};
+    }
+    for (auto buffer : codeBuffers) {
+        munmap(buffer, FB_JIT_CODE_BUFFER_SIZE);
+    }
+    codeBuffers.clear();
+    codeBufferUsed = 0;
+}
+
+#endif
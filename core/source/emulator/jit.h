@@ -0,0 +1,103 @@
+/**
+ * Copyright 2021 Michel Kremer (kremi151)
+ *
+ * Licensed under the Apache License, Version 2.0 (the License);
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef FB_CORE_JIT_H
+#define FB_CORE_JIT_H
+
+#ifdef FB_USE_JIT
+
+#include <util/typedefs.h>
+#include <memory/memory.h>
+#include <operands/instruction_context.h>
+#include <unordered_map>
+#include <vector>
+
+namespace FunkyBoy {
+
+    // Native code of a compiled block, which runs the given number of instructions on the registers array of an
+    // InstrContext
+    typedef void (*NativeBlock)(u8 *registers, u32 count);
+
+    struct CompiledInstruction {
+        const Operand *operands;
+        u8 opcode;
+        u8 immediates[2];
+        // State after this instruction, relative to the start of the block
+        u8 cycles;
+        u8 length;
+        // Values of InstrContext::lsb and InstrContext::msb after this instruction, or -1 if they are not touched
+        i16 lsb;
+        i16 msb;
+    };
+
+    struct CompiledBlock {
+        // nullptr if the block could not be compiled
+        NativeBlock code;
+        std::vector<CompiledInstruction> instructions;
+    };
+
+    /**
+     * Translates hot basic blocks located in ROM into native x86-64 code.
+     * Only instructions which exclusively operate on the registers A, B, C, D, E, H, L and F are translated. A block
+     * ends right before the first instruction which accesses memory, changes the control flow or the CPU state, so
+     * anything else is left to the interpreter.
+     */
+    class JIT {
+    private:
+        struct Slot {
+            u32 key;
+            u16 hits;
+            const CompiledBlock *block;
+        };
+
+        std::unordered_map<u32, CompiledBlock> blocks;
+        // Direct mapped lookup table in front of the block map, which also counts how often a block has been entered
+        std::vector<Slot> slots;
+
+        std::vector<u8*> codeBuffers;
+        size_t codeBufferUsed;
+
+        u32 romVersion;
+
+        const CompiledBlock *enterBlock(Memory &memory, memory_address address, u32 key);
+        const CompiledBlock *compile(Memory &memory, memory_address address, u32 key);
+        NativeBlock install(const std::vector<u8> &code);
+    public:
+        JIT();
+        ~JIT();
+
+        JIT(const JIT &other) = delete;
+        JIT &operator= (const JIT &other) = delete;
+
+        // Returns the compiled block starting at the given ROM address, or nullptr if it has to be interpreted
+        inline const CompiledBlock *lookup(Memory &memory, memory_address address) {
+            u32 key = memory.getROMBank(address) * 0x4000u | (address & 0x3fffu);
+            const Slot &slot = slots[address & (slots.size() - 1)];
+            if (slot.key == key && slot.block != nullptr && romVersion == memory.getROMVersion()) {
+                return slot.block->code != nullptr ? slot.block : nullptr;
+            }
+            return enterBlock(memory, address, key);
+        }
+
+        void clear();
+    };
+
+}
+
+#endif
+
+#endif //FB_CORE_JIT_H
@@ -0,0 +1,40 @@
+/**
+ * Copyright 2021 Michel Kremer (kremi151)
+ *
+ * Licensed under the Apache License, Version 2.0 (the License);
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef FB_CORE_MACHINE_STATE_H
+#define FB_CORE_MACHINE_STATE_H
+
+#include <emulator/io_registers.h>
+#include <emulator/ppu.h>
+#include <memory/memory.h>
+#include <memory/ppu_memory.h>
+
+namespace FunkyBoy {
+
+    /**
+     * Memory and registers of the emulated machine, kept in a single cache-aligned block which the components of an
+     * emulator refer into. The most frequently accessed state comes first.
+     */
+    struct alignas(64) MachineState {
+        IORegistersState io;
+        MemoryState memory;
+        PPUMemoryState ppuMemory;
+    };
+
+}
+
+#endif //FB_CORE_MACHINE_STATE_H
@@ -0,0 +1,39 @@
+/**
+ * Copyright 2021 Michel Kremer (kremi151)
+ *
+ * Licensed under the Apache License, Version 2.0 (the License);
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FB_CORE_PIXEL_FORMAT_H
+#define FB_CORE_PIXEL_FORMAT_H
+
+namespace FunkyBoy {
+
+    // Formats of the pixels in the frame buffer. Pixels of 16 and 32 bits are stored in native byte order.
+    enum PixelFormat {
+        // One byte per pixel, holding the shade (0-3) without any colors being applied
+        PIXEL_FORMAT_INDEXED = 0,
+
+        // 0xAARRGGBB
+        PIXEL_FORMAT_ARGB8888 = 1,
+
+        // 5 bits of red, 6 bits of green and 5 bits of blue, from the most significant bit on
+        PIXEL_FORMAT_RGB565 = 2,
+
+        // 5 bits of red, green and blue each, followed by the alpha bit
+        PIXEL_FORMAT_RGBA5551 = 3,
+    };
+
+}
+
+#endif //FB_CORE_PIXEL_FORMAT_H
@@ -18,6 +18,9 @@
 
 #include <util/return_codes.h>
 #include <emulator/io_registers.h>
+#include <emulator/scanline_compositor.h>
+#include <algorithm>
+#include <cstring>
 
 // Lower tile set lives at 0x8000 in memory
 #define FB_TILE_DATA_LOWER 0x0000
@@ -27,6 +30,11 @@
 
 #define FB_SIZEOF_TILE (8 * 2)
 
+// Lines are rendered with a margin of a tile on both sides, so that tiles and objects which are partially off screen
+// can be drawn as a whole
+#define FB_LINE_MARGIN 8
+#define FB_PADDED_LINE_WIDTH (FB_LINE_MARGIN + FB_GB_DISPLAY_WIDTH + FB_LINE_MARGIN)
+
 #define __fb_lcdc_isOn(lcdc) (lcdc & 0b10000000u)
 // Differences here are 1023
 #define __fb_lcdc_windowTileMapDisplaySelect(lcdc) ((lcdc & 0b01000000u) ? 0x1C00 : 0x1800)
@@ -50,6 +58,10 @@
 #define __fb_getTileSetOffset(lcdc, tileData) \
 (__fb_lcdc_useLowerTileData(lcdc) ? tileData : (static_cast<i8>(tileData) + 128)) * FB_SIZEOF_TILE
 
+// Index of the tile (0-383) which a tile map entry refers to
+#define __fb_getTileIndex(lcdc, tileData) \
+((__fb_getTileDataAddress(lcdc) + __fb_getTileSetOffset(lcdc, tileData)) / FB_SIZEOF_TILE)
+
 using namespace FunkyBoy;
 
 PPU::PPU(const io_registers& ioRegisters, const PPUMemory &ppuMemory)
@@ -57,8 +69,14 @@ PPU::PPU(const io_registers& ioRegisters, const PPUMemory &ppuMemory)
     , ppuMemory(ppuMemory)
     , gpuMode(GPUMode::GPUMode_2)
     , modeClocks(0)
-    , scanLineBuffer(new u8[FB_GB_DISPLAY_WIDTH])
-    , bgColorIndexes(new u8[FB_GB_DISPLAY_WIDTH])
+    , objectsPerLine{}
+    , objectsPerLineCount{}
+    , spriteLimitEnabled(false)
+    , renderPolicy(RenderPolicy::RENDER_ALWAYS)
+    , renderInterval(1)
+    , framesUntilRender(1)
+    , frameRequested(false)
+    , renderingFrame(true)
 {
     this->ppuMemory.setAccessibilityFromMMU(
             this->gpuMode != GPUMode::GPUMode_3,
@@ -66,15 +84,37 @@ PPU::PPU(const io_registers& ioRegisters, const PPUMemory &ppuMemory)
     );
 }
 
-PPU::~PPU() {
-    delete[] scanLineBuffer;
-    delete[] bgColorIndexes;
-}
-
 void PPU::onControllersUpdated(const Controller::Controllers &controllers) {
     displayController = controllers.getDisplay();
 }
 
+void PPU::setRenderPolicy(RenderPolicy policy, u32_fast frameInterval) {
+    renderPolicy = policy;
+    renderInterval = std::max<u32_fast>(frameInterval, 1);
+    framesUntilRender = 1;
+    frameRequested = false;
+}
+
+bool PPU::shouldRenderFrame() {
+    switch (renderPolicy) {
+        case RenderPolicy::RENDER_ALWAYS:
+            return true;
+        case RenderPolicy::RENDER_EVERY_NTH_FRAME:
+            if (--framesUntilRender > 0) {
+                return false;
+            }
+            framesUntilRender = renderInterval;
+            return true;
+        case RenderPolicy::RENDER_ON_REQUEST: {
+            const bool requested = frameRequested;
+            frameRequested = false;
+            return requested;
+        }
+        default:
+            return false;
+    }
+}
+
 // GPU Lifecycle:
 //
 // Period 1: Scanline (Accessing OAM)  | GPU mode 2 | 80 clocks
@@ -85,7 +125,7 @@ void PPU::onControllersUpdated(const Controller::Controllers &controllers) {
 //
 // In total for 155 scanlines => 70224 clocks
 
-ret_code PPU::doClocks(CPU &cpu, u8 clocks) {
+ret_code PPU::doClocks(CPU &cpu, u32_fast clocks) {
     // TODO: Finish implementation
     // See https://gbdev.gg8.se/wiki/articles/Video_Display#VRAM_Tile_Data
     // See http://marc.rawer.de/Gameboy/Docs/GBCPUman.pdf (pages 22-27)
@@ -102,14 +142,25 @@ ret_code PPU::doClocks(CPU &cpu, u8 clocks) {
 
     ret_code result = FB_RET_SUCCESS;
 
-    modeClocks += clocks;
-    switch (gpuMode) {
-        case GPUMode::GPUMode_0: {
-            if (modeClocks >= 204) {
+    // clocks may span multiple mode transitions, so we jump from one transition to the next
+    u16_fast nextTransition;
+    while (clocks > 0) {
+        nextTransition = getNextTransition(gpuMode, modeClocks);
+        if (modeClocks + clocks < nextTransition) {
+            modeClocks += clocks;
+            break;
+        }
+        clocks -= nextTransition - modeClocks;
+        modeClocks = nextTransition;
+
+        switch (gpuMode) {
+            case GPUMode::GPUMode_0: {
                 modeClocks = 0;
                 if (++ly >= FB_GB_DISPLAY_HEIGHT) {
                     gpuMode = GPUMode::GPUMode_1;
-                    displayController->drawScreen();
+                    if (renderingFrame) {
+                        displayController->drawScreen(frameBuffer);
+                    }
                     cpu.requestInterrupt(InterruptType::VBLANK);
                     if (__fb_stat_isVBlankInterrupt(stat)) {
                         cpu.requestInterrupt(InterruptType::LCD_STAT);
@@ -126,28 +177,26 @@ ret_code PPU::doClocks(CPU &cpu, u8 clocks) {
                 if (__fb_stat_isLYCInterrupt(stat) && ly == ioRegisters.getLYC()) {
                     cpu.requestInterrupt(InterruptType::LCD_STAT);
                 }
+                break;
             }
-            break;
-        }
-        case GPUMode::GPUMode_1: {
-            if (modeClocks >= 4560) { // 10 scan lines
-                modeClocks = 0;
-                gpuMode = GPUMode::GPUMode_2;
-                if (__fb_stat_isOAMInterrupt(stat)) {
-                    cpu.requestInterrupt(InterruptType::LCD_STAT);
-                }
-                ppuMemory.setAccessibilityFromMMU(true, false);
-                ly = 0;
-            } else if (modeClocks % 204 == 0) {
-                ly++;
-                if (__fb_stat_isLYCInterrupt(stat) && ly == ioRegisters.getLYC()) {
-                    cpu.requestInterrupt(InterruptType::LCD_STAT);
+            case GPUMode::GPUMode_1: {
+                if (modeClocks >= 4560) { // 10 scan lines
+                    modeClocks = 0;
+                    gpuMode = GPUMode::GPUMode_2;
+                    if (__fb_stat_isOAMInterrupt(stat)) {
+                        cpu.requestInterrupt(InterruptType::LCD_STAT);
+                    }
+                    ppuMemory.setAccessibilityFromMMU(true, false);
+                    ly = 0;
+                } else {
+                    ly++;
+                    if (__fb_stat_isLYCInterrupt(stat) && ly == ioRegisters.getLYC()) {
+                        cpu.requestInterrupt(InterruptType::LCD_STAT);
+                    }
                 }
+                break;
             }
-            break;
-        }
-        case GPUMode::GPUMode_2: {
-            if (modeClocks >= 80) {
+            case GPUMode::GPUMode_2: {
                 modeClocks = 0;
                 gpuMode = GPUMode::GPUMode_3;
                 ppuMemory.setAccessibilityFromMMU(false, false);
@@ -155,21 +204,25 @@ ret_code PPU::doClocks(CPU &cpu, u8 clocks) {
                     // [Workaround] Trigger LYC=LY interrupt early for LY=0
                     cpu.requestInterrupt(InterruptType::LCD_STAT);
                 }
+                break;
             }
-            break;
-        }
-        case GPUMode::GPUMode_3: {
-            if (modeClocks >= 172) {
+            case GPUMode::GPUMode_3: {
                 modeClocks = 0;
                 gpuMode = GPUMode::GPUMode_0;
                 if (__fb_stat_isHBlankInterrupt(stat)) {
                     cpu.requestInterrupt(InterruptType::LCD_STAT);
                 }
                 ppuMemory.setAccessibilityFromMMU(true, true);
-                renderScanline(ly);
+                if (ly == 0) {
+                    renderingFrame = shouldRenderFrame();
+                }
+                // LY can be out of the screen if the LCD has been switched on in an unusual state
+                if (renderingFrame && ly < FB_GB_DISPLAY_HEIGHT) {
+                    renderScanline(ly);
+                }
                 result |= FB_RET_NEW_SCANLINE;
+                break;
             }
-            break;
         }
     }
 
@@ -177,76 +230,165 @@ ret_code PPU::doClocks(CPU &cpu, u8 clocks) {
     return result;
 }
 
+u16_fast PPU::getNextTransition(GPUMode gpuMode, u16_fast modeClocks) {
+    switch (gpuMode) {
+        case GPUMode::GPUMode_0:
+            return 204;
+        case GPUMode::GPUMode_1:
+            // LY is incremented every 204 clocks during V-Blank
+            return std::min<u16_fast>(4560, (modeClocks / 204 + 1) * 204);
+        case GPUMode::GPUMode_2:
+            return 80;
+        default:
+            return 172;
+    }
+}
+
+bool PPU::isLCDOn() {
+    return __fb_lcdc_isOn(ioRegisters.getLCDC());
+}
+
+bool PPU::mayRequestInterrupt(u32_fast clocks) {
+    // Interrupts are only requested on mode transitions
+    return __fb_lcdc_isOn(ioRegisters.getLCDC()) && modeClocks + clocks >= getNextTransition(gpuMode, modeClocks);
+}
+
+u32_fast PPU::getClocksUntilInterrupt(u32_fast maxClocks) {
+    if (!__fb_lcdc_isOn(ioRegisters.getLCDC())) {
+        return maxClocks;
+    }
+    const u8 stat = ioRegisters.getSTAT();
+    const u8 lyc = ioRegisters.getLYC();
+    u8 ly = ioRegisters.getLY();
+
+    // Follows the mode transitions of doClocks without performing them
+    GPUMode mode = gpuMode;
+    u16_fast clocks = modeClocks;
+    u32_fast totalClocks = 0;
+    bool requestsInterrupt;
+    while (totalClocks < maxClocks) {
+        u16_fast nextTransition = getNextTransition(mode, clocks);
+        totalClocks += nextTransition - clocks;
+        clocks = nextTransition;
+
+        switch (mode) {
+            case GPUMode::GPUMode_0: {
+                clocks = 0;
+                if (++ly >= FB_GB_DISPLAY_HEIGHT) {
+                    // V-Blank interrupt
+                    return totalClocks;
+                }
+                mode = GPUMode::GPUMode_2;
+                requestsInterrupt = __fb_stat_isOAMInterrupt(stat) || (__fb_stat_isLYCInterrupt(stat) && ly == lyc);
+                break;
+            }
+            case GPUMode::GPUMode_1: {
+                if (clocks >= 4560) {
+                    clocks = 0;
+                    mode = GPUMode::GPUMode_2;
+                    requestsInterrupt = __fb_stat_isOAMInterrupt(stat);
+                    ly = 0;
+                } else {
+                    ly++;
+                    requestsInterrupt = __fb_stat_isLYCInterrupt(stat) && ly == lyc;
+                }
+                break;
+            }
+            case GPUMode::GPUMode_2: {
+                clocks = 0;
+                mode = GPUMode::GPUMode_3;
+                requestsInterrupt = ly == 0 && __fb_stat_isLYCInterrupt(stat) && lyc == 0;
+                break;
+            }
+            case GPUMode::GPUMode_3: {
+                clocks = 0;
+                mode = GPUMode::GPUMode_0;
+                requestsInterrupt = __fb_stat_isHBlankInterrupt(stat);
+                break;
+            }
+        }
+        if (requestsInterrupt) {
+            return totalClocks;
+        }
+    }
+    return maxClocks;
+}
+
+u32_fast PPU::getClocksUntilLYChange(u32_fast maxClocks) {
+    if (!__fb_lcdc_isOn(ioRegisters.getLCDC())) {
+        return maxClocks;
+    }
+    // LY changes on every transition except for the ones within a scan line
+    u32_fast totalClocks = getNextTransition(gpuMode, modeClocks) - modeClocks;
+    if (gpuMode == GPUMode::GPUMode_2) {
+        totalClocks += getNextTransition(GPUMode::GPUMode_3, 0);
+    }
+    if (gpuMode == GPUMode::GPUMode_2 || gpuMode == GPUMode::GPUMode_3) {
+        totalClocks += getNextTransition(GPUMode::GPUMode_0, 0);
+    }
+    return std::min(totalClocks, maxClocks);
+}
+
+u32_fast PPU::getClocksUntilSTATChange(u32_fast maxClocks) {
+    if (!__fb_lcdc_isOn(ioRegisters.getLCDC())) {
+        return maxClocks;
+    }
+    return std::min<u32_fast>(getNextTransition(gpuMode, modeClocks) - modeClocks, maxClocks);
+}
+
 void PPU::renderScanline(u8 ly) {
     const u8 &lcdc = ioRegisters.getLCDC();
-    const memory_address tileSetAddr = __fb_getTileDataAddress(lcdc);
     const bool bgEnabled = __fb_lcdc_isBGEnabled(lcdc);
     const bool objEnabled = __fb_lcdc_objEnabled(lcdc);
     const bool windowEnabled = __fb_lcdc_isWindowEnabled(lcdc);
+    // Color indices of the BG and the window and the shades of the line, each with a margin on both sides
+    u8 bgLine[FB_PADDED_LINE_WIDTH]{};
+    u8 windowLine[FB_PADDED_LINE_WIDTH];
+    u8 shades[FB_PADDED_LINE_WIDTH]{};
     u16 y;
     u8 tileOffsetX;
-    u8 xInTile;
     u8 yInTile;
     u16 tile;
-    u16 tileLine;
     u8 palette;
-    u8 colorIndex;
     int it;
     if (bgEnabled) {
         const u8 &scx = ioRegisters.getSCX();
         const u8 &scy = ioRegisters.getSCY();
         y = ly + scy;
         tileOffsetX = scx / 8;
-        xInTile = scx % 8;
         yInTile = y % 8;
         memory_address tileMapAddr = __fb_lcdc_bgTileMapDisplaySelect(lcdc);
         tileMapAddr += ((y & 255u) / 8) * 32;
-        palette = ioRegisters.getBGP();
-        tile = ppuMemory.getVRAMByte(tileMapAddr + tileOffsetX);
-        int &scanLineX = it; // alias for it
-        for (scanLineX = 0 ; scanLineX < FB_GB_DISPLAY_WIDTH ; scanLineX++) {
-            tileLine = ppuMemory.readVRAM16Bits(tileSetAddr + __fb_getTileSetOffset(lcdc, tile) + (yInTile * 2));
-            colorIndex = (tileLine >> (7 - xInTile)) & 1u
-                | ((tileLine >> (15 - xInTile)) & 1u) << 1;
-            scanLineBuffer[scanLineX] = (palette >> (colorIndex * 2u)) & 3u;
-            bgColorIndexes[scanLineX] = colorIndex;
-            if (++xInTile >= 8) {
-                xInTile = 0;
-                tileOffsetX = (tileOffsetX + 1) & 31;
-                tile = ppuMemory.getVRAMByte(tileMapAddr + tileOffsetX);
-            }
-        }
-    } else {
-        // Clear scan line buffer
-        int &scanLineX = it; // alias for it
-        for (scanLineX = 0 ; scanLineX < FB_GB_DISPLAY_WIDTH ; scanLineX++) {
-            scanLineBuffer[scanLineX] = 0;
-            bgColorIndexes[scanLineX] = 0;
+        // The first tile starts up to 7 pixels left of the display
+        int &lineX = it; // alias for it
+        for (lineX = FB_LINE_MARGIN - (scx % 8) ; lineX < FB_LINE_MARGIN + FB_GB_DISPLAY_WIDTH ; lineX += 8) {
+            tile = ppuMemory.getVRAMByte(tileMapAddr + tileOffsetX);
+            std::memcpy(bgLine + lineX, ppuMemory.getDecodedTileRow(__fb_getTileIndex(lcdc, tile), yInTile, false), 8);
+            tileOffsetX = (tileOffsetX + 1) & 31;
         }
+        Compositor::applyPalette(shades + FB_LINE_MARGIN, bgLine + FB_LINE_MARGIN, FB_GB_DISPLAY_WIDTH, ioRegisters.getBGP());
     }
+    // If the BG is disabled, both the color indices and the shades are left at 0
     if (windowEnabled) {
         const u8 wy = ioRegisters.getWY();
         if (ly >= wy) {
             y = ly - wy;
             yInTile = y % 8;
-            xInTile = 0;
             tileOffsetX = 0;
             const int wx = ioRegisters.getWX() - 7;
             memory_address tileMapAddr = __fb_lcdc_windowTileMapDisplaySelect(lcdc);
             tileMapAddr += ((y & 255u) / 8) * 32;
-            palette = ioRegisters.getBGP();
-            tile = ppuMemory.getVRAMByte(tileMapAddr + tileOffsetX);
-            int &scanLineX = it; // alias for it
-            for (scanLineX = wx ; scanLineX < FB_GB_DISPLAY_WIDTH ; scanLineX++) {
-                tileLine = ppuMemory.readVRAM16Bits(tileSetAddr + __fb_getTileSetOffset(lcdc, tile) + (yInTile * 2));
-                colorIndex = (tileLine >> (7 - xInTile)) & 1u
-                    | ((tileLine >> (15 - xInTile)) & 1u) << 1;
-                scanLineBuffer[scanLineX] = (palette >> (colorIndex * 2u)) & 3u;
-                if (++xInTile >= 8) {
-                    xInTile = 0;
-                    tileOffsetX = (tileOffsetX + 1) & 31;
-                    tile = ppuMemory.getVRAMByte(tileMapAddr + tileOffsetX);
-                }
+            int &lineX = it; // alias for it
+            for (lineX = FB_LINE_MARGIN + wx ; lineX < FB_LINE_MARGIN + FB_GB_DISPLAY_WIDTH ; lineX += 8) {
+                tile = ppuMemory.getVRAMByte(tileMapAddr + tileOffsetX);
+                std::memcpy(windowLine + lineX, ppuMemory.getDecodedTileRow(__fb_getTileIndex(lcdc, tile), yInTile, false), 8);
+                tileOffsetX = (tileOffsetX + 1) & 31;
+            }
+            // With WX < 7, the first columns of the window lie left of the display
+            const int windowX = std::max(wx, 0);
+            if (windowX < FB_GB_DISPLAY_WIDTH) {
+                Compositor::applyPalette(shades + FB_LINE_MARGIN + windowX, windowLine + FB_LINE_MARGIN + windowX,
+                                         FB_GB_DISPLAY_WIDTH - windowX, ioRegisters.getBGP());
             }
         }
     }
@@ -254,20 +396,36 @@ void PPU::renderScanline(u8 ly) {
         const u8 objPalette0 = ioRegisters.getOBP0();
         const u8 objPalette1 = ioRegisters.getOBP1();
         const u8 objHeight = __fb_lcdc_objSpriteSize(lcdc);
-        // A B C D E F
-        memory_address objAddr = 0x009C; // 0x009C ~> 0xFE9C (last 4 bytes of OAM)
+        if (ppuMemory.clearOAMChanged()) {
+            sortObjectsIntoLines();
+        }
+        // Objects which overlap this line at their actual height, limited to the first 10 if enabled
+        u8 lineObjects[FB_OBJ_COUNT];
+        u8 lineObjectCount = 0;
+        for (u8 i = 0 ; i < objectsPerLineCount[ly] ; i++) {
+            const u8 objIdx = objectsPerLine[ly][i];
+            if (ly >= ppuMemory.getOAMByte(objIdx * 4) - 16 + objHeight) {
+                continue;
+            }
+            lineObjects[lineObjectCount++] = objIdx;
+            if (spriteLimitEnabled && lineObjectCount >= FB_OBJS_PER_LINE) {
+                break;
+            }
+        }
+        memory_address objAddr;
         int objY, objX;
         u8 objFlags;
         bool hide, flipX, flipY;
         u8 yInObj;
-        int &objIdx = it; // alias for it
-        for (objIdx = 0 ; objIdx < 40 ; objIdx++) {
+        // Objects with lower indices are drawn on top of the others, so they are drawn last
+        for (it = lineObjectCount - 1 ; it >= 0 ; it--) {
+            objAddr = lineObjects[it] * 4;
             objY = ppuMemory.getOAMByte(objAddr) - 16;
             objX = ppuMemory.getOAMByte(objAddr + 1);
             tile = ppuMemory.getOAMByte(objAddr + 2);
             objFlags = ppuMemory.getOAMByte(objAddr + 3);
-            objAddr -= 4;
-            if (ly < objY || ly >= objY + objHeight) {
+            // The object starts at objX - 8 on the display, which is objX on the padded line
+            if (objX == 0 || objX >= FB_LINE_MARGIN + FB_GB_DISPLAY_WIDTH) {
                 continue;
             }
             palette = (objFlags & 0b00010000u) ? objPalette1 : objPalette0;
@@ -284,29 +442,24 @@ void PPU::renderScanline(u8 ly) {
                 // In 8x16 mode, the least significant bit of the tile number is treated as '0'
                 tile &= 0b11111110u;
             }
-            tileLine = ppuMemory.readVRAM16Bits(FB_TILE_DATA_LOWER + (tile * FB_SIZEOF_TILE) + (yInObj * 2));
-            for (u8 xOnObj = 0 ; xOnObj < 8 ; xOnObj++) {
-                u8 x = objX + xOnObj - 8;
-                if (x >= FB_GB_DISPLAY_WIDTH) {
-                    // Out of display bounds
-                    continue;
-                }
-                if (!hide || !bgColorIndexes[x]) {
-                    if (flipX) {
-                        colorIndex = (tileLine >> xOnObj) & 1u
-                            | ((tileLine >> (8 + xOnObj)) & 1u) << 1;
-                    } else {
-                        colorIndex = (tileLine >> (7 - xOnObj)) & 1u
-                            | ((tileLine >> (15 - xOnObj)) & 1u) << 1;
-                    }
-                    if (colorIndex) {
-                        scanLineBuffer[x] = (palette >> (colorIndex * 2u)) & 3u;
-                    }
-                }
-            }
+            // Objects always use the lower tile data, in 8x16 mode the lower half lies in the next tile
+            Compositor::drawObjectRow(shades + objX, bgLine + objX,
+                                      ppuMemory.getDecodedTileRow(tile + yInObj / 8, yInObj % 8, flipX), palette, hide);
+        }
+    }
+    frameBuffer.drawLine(ly, shades + FB_LINE_MARGIN);
+}
+
+void PPU::sortObjectsIntoLines() {
+    std::fill(std::begin(objectsPerLineCount), std::end(objectsPerLineCount), 0);
+    for (u8 objIdx = 0 ; objIdx < FB_OBJ_COUNT ; objIdx++) {
+        // Objects are sorted in as 8x16 ones, so that switching between 8x8 and 8x16 mode does not require sorting
+        const int objY = ppuMemory.getOAMByte(objIdx * 4) - 16;
+        const int lastLine = std::min(objY + 16, FB_GB_DISPLAY_HEIGHT);
+        for (int line = std::max(objY, 0) ; line < lastLine ; line++) {
+            objectsPerLine[line][objectsPerLineCount[line]++] = objIdx;
         }
     }
-    displayController->drawScanLine(ly, scanLineBuffer);
 }
 
 void PPU::updateStat(u8 &stat, u8 ly, bool lcdOn) {
@@ -322,3 +475,13 @@ void PPU::updateStat(u8 &stat, u8 ly, bool lcdOn) {
     }
     // TODO: Is it correct to let bits 0 & 1 be '0' is LCD is off?
 }
+
+void PPU::saveSnapshot(Snapshot::Writer &writer) const {
+    writer.write(gpuMode);
+    writer.write(modeClocks);
+}
+
+void PPU::loadSnapshot(Snapshot::Reader &reader) {
+    reader.read(gpuMode);
+    reader.read(modeClocks);
+}
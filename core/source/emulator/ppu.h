@@ -19,11 +19,20 @@
 
 #include <controllers/display.h>
 #include <emulator/cpu.h>
+#include <emulator/frame_buffer.h>
 #include <emulator/io_registers.h>
+#include <emulator/render_policy.h>
 #include <memory/ppu_memory.h>
 #include <util/gpumode.h>
 #include <util/configurable.h>
+#include <util/snapshot.h>
 #include <util/typedefs.h>
+#include <memory>
+
+// Number of objects in the OAM
+#define FB_OBJ_COUNT 40
+// Number of objects which the hardware draws at most on a single line
+#define FB_OBJS_PER_LINE 10
 
 namespace FunkyBoy {
 
@@ -37,18 +46,77 @@ namespace FunkyBoy {
 
         u16 modeClocks;
 
-        u8 *scanLineBuffer;
-        u8 *bgColorIndexes;
+        FrameBuffer frameBuffer;
+
+        // Indices of the objects which would overlap each line if they were 16 pixels high, in the order of their
+        // priority. This is sorted again after the OAM has been written to.
+        u8 objectsPerLine[FB_GB_DISPLAY_HEIGHT][FB_OBJ_COUNT];
+        u8 objectsPerLineCount[FB_GB_DISPLAY_HEIGHT];
+        bool spriteLimitEnabled;
+
+        RenderPolicy renderPolicy;
+        u32_fast renderInterval;
+        u32_fast framesUntilRender;
+        bool frameRequested;
+        // Whether the current frame is drawn, which is decided when its first line is reached
+        bool renderingFrame;
 
+        static u16_fast getNextTransition(GPUMode gpuMode, u16_fast modeClocks);
+        void sortObjectsIntoLines();
+        bool shouldRenderFrame();
         void renderScanline(u8 ly);
         void updateStat(u8 &stat, u8 ly, bool lcdOn);
     public:
         PPU(const io_registers& ioRegisters, const PPUMemory &ppuMemory);
-        ~PPU();
 
         void onControllersUpdated(const Controller::Controllers &controllers) override;
 
-        ret_code doClocks(CPU &cpu, u8 clocks);
+        inline FrameBuffer &getFrameBuffer() {
+            return frameBuffer;
+        }
+
+        inline const FrameBuffer &getFrameBuffer() const {
+            return frameBuffer;
+        }
+
+        // Only draws the first 10 objects of each line, like the hardware does. This is disabled by default.
+        inline void setSpriteLimitEnabled(bool enabled) {
+            spriteLimitEnabled = enabled;
+        }
+
+        inline bool isSpriteLimitEnabled() const {
+            return spriteLimitEnabled;
+        }
+
+        // The frame interval is only used by RENDER_EVERY_NTH_FRAME
+        void setRenderPolicy(RenderPolicy policy, u32_fast frameInterval);
+
+        inline RenderPolicy getRenderPolicy() const {
+            return renderPolicy;
+        }
+
+        inline u32_fast getRenderInterval() const {
+            return renderInterval;
+        }
+
+        // Draws the next frame which starts, if the render policy is RENDER_ON_REQUEST
+        inline void requestFrame() {
+            frameRequested = true;
+        }
+
+        ret_code doClocks(CPU &cpu, u32_fast clocks);
+        bool isLCDOn();
+        // Returns whether doClocks could request an interrupt within the given number of clocks
+        bool mayRequestInterrupt(u32_fast clocks);
+        // Returns the number of clocks until the next mode transition which requests an interrupt, or maxClocks if
+        // there is none before
+        u32_fast getClocksUntilInterrupt(u32_fast maxClocks);
+        // Return the number of clocks until doClocks changes LY or STAT, or maxClocks if it does not change before
+        u32_fast getClocksUntilLYChange(u32_fast maxClocks);
+        u32_fast getClocksUntilSTATChange(u32_fast maxClocks);
+
+        void saveSnapshot(Snapshot::Writer &writer) const;
+        void loadSnapshot(Snapshot::Reader &reader);
     };
 
 }
@@ -0,0 +1,38 @@
+/**
+ * Copyright 2021 Michel Kremer (kremi151)
+ *
+ * Licensed under the Apache License, Version 2.0 (the License);
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FB_CORE_RENDER_POLICY_H
+#define FB_CORE_RENDER_POLICY_H
+
+namespace FunkyBoy {
+
+    // Tells which frames the PPU draws. Frames which are not drawn are emulated with exact timing, but no pixels are
+    // generated for them and the display controller is not invoked.
+    enum RenderPolicy {
+        RENDER_ALWAYS = 0,
+
+        // Only every n-th frame is drawn, starting with the next one
+        RENDER_EVERY_NTH_FRAME = 1,
+
+        // Only frames which have been requested through Emulator::requestFrame() are drawn
+        RENDER_ON_REQUEST = 2,
+
+        RENDER_NEVER = 3,
+    };
+
+}
+
+#endif //FB_CORE_RENDER_POLICY_H
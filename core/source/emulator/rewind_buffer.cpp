@@ -0,0 +1,225 @@
+/**
+ * Copyright 2021 Michel Kremer (kremi151)
+ *
+ * Licensed under the Apache License, Version 2.0 (the License);
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "rewind_buffer.h"
+
+#include <cstring>
+
+// Changed bytes which are separated by fewer unchanged bytes are stored as one literal run
+#define FB_REWIND_MIN_SKIP 8
+#define FB_REWIND_MAX_VARINT_BYTES 10
+
+using namespace FunkyBoy;
+
+namespace FunkyBoy {
+
+    inline u8 *writeVarint(u8 *out, size_t value) {
+        while (value >= 0x80) {
+            *out++ = static_cast<u8>(value | 0x80u);
+            value >>= 7u;
+        }
+        *out++ = static_cast<u8>(value);
+        return out;
+    }
+
+    inline const u8 *readVarint(const u8 *in, size_t &value) {
+        value = 0;
+        unsigned shift = 0;
+        u8 byte;
+        do {
+            byte = *in++;
+            value |= static_cast<size_t>(byte & 0x7fu) << shift;
+            shift += 7;
+        } while (byte & 0x80u);
+        return in;
+    }
+
+    // Returns the first offset from the given one at which both buffers differ, or size if there is none
+    inline size_t skipEqual(const u8 *data, const u8 *reference, size_t offset, size_t size) {
+        u64 word, referenceWord;
+        while (offset + sizeof(u64) <= size) {
+            std::memcpy(&word, data + offset, sizeof(u64));
+            std::memcpy(&referenceWord, reference + offset, sizeof(u64));
+            if (word != referenceWord) {
+                break;
+            }
+            offset += sizeof(u64);
+        }
+        while (offset < size && data[offset] == reference[offset]) {
+            offset++;
+        }
+        return offset;
+    }
+
+    /**
+     * Encodes the difference between both buffers as a sequence of pairs of run lengths, the first one counting the
+     * unchanged bytes to skip, the second one the XOR-ed bytes which follow it. Unchanged bytes at the end are omitted.
+     */
+    inline size_t encodeDelta(const u8 *data, const u8 *reference, size_t size, u8 *out) {
+        u8 *ptr = out;
+        size_t offset = 0;
+        while (offset < size) {
+            size_t start = skipEqual(data, reference, offset, size);
+            if (start == size) {
+                break;
+            }
+            size_t end = start + 1;
+            while (end < size) {
+                size_t next = skipEqual(data, reference, end, size);
+                if (next == size || next - end >= FB_REWIND_MIN_SKIP) {
+                    break;
+                }
+                end = next + 1;
+            }
+            ptr = writeVarint(ptr, start - offset);
+            ptr = writeVarint(ptr, end - start);
+            for (size_t i = start ; i < end ; i++) {
+                *ptr++ = data[i] ^ reference[i];
+            }
+            offset = end;
+        }
+        return ptr - out;
+    }
+
+    inline void applyDelta(const u8 *in, size_t length, u8 *data) {
+        const u8 *end = in + length;
+        size_t skip, literal;
+        while (in < end) {
+            in = readVarint(in, skip);
+            in = readVarint(in, literal);
+            data += skip;
+            for (size_t i = 0 ; i < literal ; i++) {
+                *data++ ^= *in++;
+            }
+        }
+    }
+
+}
+
+RewindBuffer::RewindBuffer(size_t snapshotSize, size_t capacity, u32_fast keyframeInterval)
+    : snapshotSize(snapshotSize)
+    , keyframeInterval(keyframeInterval)
+    , storage(capacity)
+    , head(0)
+    , usedBytes(0)
+    , keyframe(snapshotSize)
+    , keyframeDecoded(false)
+    , deltasSinceKeyframe(0)
+    , zeros(snapshotSize)
+    // Every literal run but the first one is preceded by at least FB_REWIND_MIN_SKIP unchanged bytes
+    , encoded(snapshotSize + 2 * FB_REWIND_MAX_VARINT_BYTES * (snapshotSize / FB_REWIND_MIN_SKIP + 1))
+{
+}
+
+u8 *RewindBuffer::reserve(size_t length) {
+    if (length > storage.size()) {
+        return nullptr;
+    }
+    if (entries.empty()) {
+        head = 0;
+    }
+    if (head + length > storage.size()) {
+        // Entries behind the write position are the oldest ones, so they are dropped before wrapping around
+        while (!entries.empty() && entries.front().offset >= head) {
+            dropOldest();
+        }
+        head = 0;
+    }
+    while (!entries.empty() && entries.front().offset >= head && entries.front().offset < head + length) {
+        dropOldest();
+    }
+    u8 *ptr = storage.data() + head;
+    head += length;
+    return ptr;
+}
+
+void RewindBuffer::dropOldest() {
+    // Deltas cannot be decoded without their keyframe
+    do {
+        usedBytes -= entries.front().length;
+        entries.pop_front();
+    } while (!entries.empty() && !entries.front().keyframe);
+    if (entries.empty()) {
+        keyframeDecoded = false;
+    }
+}
+
+void RewindBuffer::decodeKeyframe() {
+    size_t index = entries.size() - 1;
+    while (!entries[index].keyframe) {
+        index--;
+    }
+    const Entry &entry = entries[index];
+    std::memset(keyframe.data(), 0, snapshotSize);
+    applyDelta(storage.data() + entry.offset, entry.length, keyframe.data());
+    keyframeDecoded = true;
+    deltasSinceKeyframe = entries.size() - 1 - index;
+}
+
+void RewindBuffer::push(const u8 *snapshot) {
+    bool isKeyframe = !keyframeDecoded || deltasSinceKeyframe >= keyframeInterval;
+    size_t length = encodeDelta(snapshot, isKeyframe ? zeros.data() : keyframe.data(), snapshotSize, encoded.data());
+    u8 *ptr = reserve(length);
+    if (!isKeyframe && !keyframeDecoded) {
+        // The keyframe had to be dropped to make room for the delta
+        isKeyframe = true;
+        length = encodeDelta(snapshot, zeros.data(), snapshotSize, encoded.data());
+        ptr = reserve(length);
+    }
+    if (ptr == nullptr) {
+        return;
+    }
+    std::memcpy(ptr, encoded.data(), length);
+    entries.push_back({static_cast<size_t>(ptr - storage.data()), length, isKeyframe});
+    usedBytes += length;
+    if (isKeyframe) {
+        std::memcpy(keyframe.data(), snapshot, snapshotSize);
+        keyframeDecoded = true;
+        deltasSinceKeyframe = 0;
+    } else {
+        deltasSinceKeyframe++;
+    }
+}
+
+bool RewindBuffer::pop(u8 *snapshot) {
+    if (entries.empty()) {
+        return false;
+    }
+    Entry entry = entries.back();
+    if (entry.keyframe) {
+        std::memset(snapshot, 0, snapshotSize);
+        keyframeDecoded = false;
+    } else {
+        if (!keyframeDecoded) {
+            decodeKeyframe();
+        }
+        std::memcpy(snapshot, keyframe.data(), snapshotSize);
+        deltasSinceKeyframe--;
+    }
+    applyDelta(storage.data() + entry.offset, entry.length, snapshot);
+    entries.pop_back();
+    usedBytes -= entry.length;
+    head = entry.offset;
+    return true;
+}
+
+void RewindBuffer::clear() {
+    entries.clear();
+    head = 0;
+    usedBytes = 0;
+    keyframeDecoded = false;
+    deltasSinceKeyframe = 0;
+}
@@ -0,0 +1,98 @@
+/**
+ * Copyright 2021 Michel Kremer (kremi151)
+ *
+ * Licensed under the Apache License, Version 2.0 (the License);
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FB_CORE_REWIND_BUFFER_H
+#define FB_CORE_REWIND_BUFFER_H
+
+#include <util/typedefs.h>
+#include <vector>
+#include <deque>
+#include <cstddef>
+
+namespace FunkyBoy {
+
+    /**
+     * Keeps the most recent snapshots of an emulator within a ring buffer of fixed capacity. Every snapshot is stored
+     * as the XOR difference to the last keyframe, in which runs of unchanged bytes are skipped. As most of the machine
+     * state does not change between frames, a difference usually takes up a small fraction of a full snapshot.
+     * Keyframes are encoded the same way against an empty snapshot. Once the buffer is full, the oldest keyframe is
+     * dropped along with the snapshots which depend on it.
+     */
+    class RewindBuffer {
+    private:
+        struct Entry {
+            size_t offset;
+            size_t length;
+            bool keyframe;
+        };
+
+        const size_t snapshotSize;
+        const u32_fast keyframeInterval;
+
+        std::vector<u8> storage;
+        std::deque<Entry> entries;
+        // Position at which the next entry is written
+        size_t head;
+        size_t usedBytes;
+
+        // Decoded keyframe which the newest entry belongs to, if keyframeDecoded is set
+        std::vector<u8> keyframe;
+        bool keyframeDecoded;
+        u32_fast deltasSinceKeyframe;
+
+        std::vector<u8> zeros;
+        std::vector<u8> encoded;
+
+        u8 *reserve(size_t length);
+        void dropOldest();
+        void decodeKeyframe();
+
+    public:
+        RewindBuffer(size_t snapshotSize, size_t capacity, u32_fast keyframeInterval);
+
+        RewindBuffer(const RewindBuffer &other) = delete;
+        RewindBuffer &operator= (const RewindBuffer &other) = delete;
+
+        // Adds a snapshot of getSnapshotSize() bytes, dropping the oldest ones if there is not enough room left
+        void push(const u8 *snapshot);
+
+        // Removes the newest snapshot and decodes it into the given buffer of getSnapshotSize() bytes. Returns false if
+        // the buffer is empty.
+        bool pop(u8 *snapshot);
+
+        void clear();
+
+        inline size_t getSnapshotSize() const {
+            return snapshotSize;
+        }
+
+        inline size_t getSnapshotCount() const {
+            return entries.size();
+        }
+
+        inline size_t getCapacity() const {
+            return storage.size();
+        }
+
+        // Returns the number of bytes which are taken up by the encoded snapshots
+        inline size_t getUsedBytes() const {
+            return usedBytes;
+        }
+    };
+
+}
+
+#endif //FB_CORE_REWIND_BUFFER_H
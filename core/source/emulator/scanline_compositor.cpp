@@ -0,0 +1,180 @@
+/**
+ * Copyright 2021 Michel Kremer (kremi151)
+ *
+ * Licensed under the Apache License, Version 2.0 (the License);
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "scanline_compositor.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSSE3__)
+#include <tmmintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace FunkyBoy::Compositor {
+
+    inline u8 lookUpShade(u8 palette, u8 colorIndex) {
+        return (palette >> (colorIndex * 2u)) & 3u;
+    }
+
+#if defined(__SSSE3__)
+    inline __m128i makePaletteTable(u8 palette) {
+        return _mm_setr_epi8(
+                lookUpShade(palette, 0), lookUpShade(palette, 1), lookUpShade(palette, 2), lookUpShade(palette, 3),
+                0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+        );
+    }
+
+    inline __m128i lookUpShades(__m128i table, __m128i colorIndexes) {
+        return _mm_shuffle_epi8(table, colorIndexes);
+    }
+#elif defined(__SSE2__)
+    // Without byte shuffles, each of the 4 shades is selected by comparing the color indexes
+    struct PaletteTable {
+        __m128i shades[4];
+    };
+
+    inline PaletteTable makePaletteTable(u8 palette) {
+        PaletteTable table{};
+        for (u8 colorIndex = 0 ; colorIndex < 4 ; colorIndex++) {
+            table.shades[colorIndex] = _mm_set1_epi8(static_cast<char>(lookUpShade(palette, colorIndex)));
+        }
+        return table;
+    }
+
+    inline __m128i lookUpShades(const PaletteTable &table, __m128i colorIndexes) {
+        __m128i result = _mm_setzero_si128();
+        for (u8 colorIndex = 1 ; colorIndex < 4 ; colorIndex++) {
+            const __m128i mask = _mm_cmpeq_epi8(colorIndexes, _mm_set1_epi8(static_cast<char>(colorIndex)));
+            result = _mm_or_si128(result, _mm_and_si128(mask, table.shades[colorIndex]));
+        }
+        const __m128i mask = _mm_cmpeq_epi8(colorIndexes, _mm_setzero_si128());
+        return _mm_or_si128(result, _mm_and_si128(mask, table.shades[0]));
+    }
+#endif
+
+    void applyPalette(u8 *shades, const u8 *colorIndexes, size_t count, u8 palette) {
+        size_t i = 0;
+#if defined(__AVX2__)
+        // The table is repeated in both lanes, as bytes are only shuffled within 128 bits
+        const __m256i wideTable = _mm256_broadcastsi128_si256(makePaletteTable(palette));
+        for ( ; i + 32 <= count ; i += 32) {
+            const __m256i indexes = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(colorIndexes + i));
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(shades + i), _mm256_shuffle_epi8(wideTable, indexes));
+        }
+#endif
+#if defined(__SSE2__)
+        const auto table = makePaletteTable(palette);
+        for ( ; i + 16 <= count ; i += 16) {
+            const __m128i indexes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(colorIndexes + i));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(shades + i), lookUpShades(table, indexes));
+        }
+#endif
+        for ( ; i < count ; i++) {
+            shades[i] = lookUpShade(palette, colorIndexes[i]);
+        }
+    }
+
+#if defined(__SSE2__)
+    // Selects the color of each 16-bit or 32-bit lane by comparing it with the shades
+    inline __m128i lookUpColors16(const __m128i *colors, __m128i shades) {
+        __m128i result = _mm_setzero_si128();
+        for (u8 shade = 0 ; shade < 4 ; shade++) {
+            const __m128i mask = _mm_cmpeq_epi16(shades, _mm_set1_epi16(shade));
+            result = _mm_or_si128(result, _mm_and_si128(mask, colors[shade]));
+        }
+        return result;
+    }
+
+    inline __m128i lookUpColors32(const __m128i *colors, __m128i shades) {
+        __m128i result = _mm_setzero_si128();
+        for (u8 shade = 0 ; shade < 4 ; shade++) {
+            const __m128i mask = _mm_cmpeq_epi32(shades, _mm_set1_epi32(shade));
+            result = _mm_or_si128(result, _mm_and_si128(mask, colors[shade]));
+        }
+        return result;
+    }
+#endif
+
+    void applyColors(u16 *pixels, const u8 *shades, size_t count, const u32 (&colors)[4]) {
+        size_t i = 0;
+#if defined(__SSE2__)
+        const __m128i wideColors[4] = {
+                _mm_set1_epi16(static_cast<short>(colors[0])), _mm_set1_epi16(static_cast<short>(colors[1])),
+                _mm_set1_epi16(static_cast<short>(colors[2])), _mm_set1_epi16(static_cast<short>(colors[3]))
+        };
+        const __m128i zero = _mm_setzero_si128();
+        for ( ; i + 16 <= count ; i += 16) {
+            const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(shades + i));
+            auto out = reinterpret_cast<__m128i *>(pixels + i);
+            _mm_storeu_si128(out, lookUpColors16(wideColors, _mm_unpacklo_epi8(bytes, zero)));
+            _mm_storeu_si128(out + 1, lookUpColors16(wideColors, _mm_unpackhi_epi8(bytes, zero)));
+        }
+#endif
+        for ( ; i < count ; i++) {
+            pixels[i] = static_cast<u16>(colors[shades[i] & 3u]);
+        }
+    }
+
+    void applyColors(u32 *pixels, const u8 *shades, size_t count, const u32 (&colors)[4]) {
+        size_t i = 0;
+#if defined(__SSE2__)
+        const __m128i wideColors[4] = {
+                _mm_set1_epi32(static_cast<int>(colors[0])), _mm_set1_epi32(static_cast<int>(colors[1])),
+                _mm_set1_epi32(static_cast<int>(colors[2])), _mm_set1_epi32(static_cast<int>(colors[3]))
+        };
+        const __m128i zero = _mm_setzero_si128();
+        for ( ; i + 16 <= count ; i += 16) {
+            const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(shades + i));
+            const __m128i low = _mm_unpacklo_epi8(bytes, zero);
+            const __m128i high = _mm_unpackhi_epi8(bytes, zero);
+            auto out = reinterpret_cast<__m128i *>(pixels + i);
+            _mm_storeu_si128(out, lookUpColors32(wideColors, _mm_unpacklo_epi16(low, zero)));
+            _mm_storeu_si128(out + 1, lookUpColors32(wideColors, _mm_unpackhi_epi16(low, zero)));
+            _mm_storeu_si128(out + 2, lookUpColors32(wideColors, _mm_unpacklo_epi16(high, zero)));
+            _mm_storeu_si128(out + 3, lookUpColors32(wideColors, _mm_unpackhi_epi16(high, zero)));
+        }
+#endif
+        for ( ; i < count ; i++) {
+            pixels[i] = colors[shades[i] & 3u];
+        }
+    }
+
+    void drawObjectRow(u8 *shades, const u8 *bgColorIndexes, const u8 *objColorIndexes, u8 palette, bool behindBG) {
+#if defined(__SSE2__)
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i indexes = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(objColorIndexes));
+        // Mask of the pixels which are not drawn
+        __m128i hidden = _mm_cmpeq_epi8(indexes, zero);
+        if (behindBG) {
+            const __m128i bg = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(bgColorIndexes));
+            hidden = _mm_or_si128(hidden, _mm_xor_si128(_mm_cmpeq_epi8(bg, zero), _mm_set1_epi8(-1)));
+        }
+        const __m128i current = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(shades));
+        const __m128i objShades = lookUpShades(makePaletteTable(palette), indexes);
+        const __m128i result = _mm_or_si128(_mm_and_si128(hidden, current), _mm_andnot_si128(hidden, objShades));
+        _mm_storel_epi64(reinterpret_cast<__m128i *>(shades), result);
+#else
+        for (u8 x = 0 ; x < 8 ; x++) {
+            const u8 colorIndex = objColorIndexes[x];
+            if (colorIndex && (!behindBG || !bgColorIndexes[x])) {
+                shades[x] = lookUpShade(palette, colorIndex);
+            }
+        }
+#endif
+    }
+
+}
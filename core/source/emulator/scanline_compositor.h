@@ -0,0 +1,40 @@
+/**
+ * Copyright 2021 Michel Kremer (kremi151)
+ *
+ * Licensed under the Apache License, Version 2.0 (the License);
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FB_CORE_SCANLINE_COMPOSITOR_H
+#define FB_CORE_SCANLINE_COMPOSITOR_H
+
+#include <util/typedefs.h>
+
+#include <cstddef>
+
+namespace FunkyBoy::Compositor {
+
+    // Maps color indices (0-3) to shades through a palette register (BGP, OBP0 or OBP1)
+    void applyPalette(u8 *shades, const u8 *colorIndexes, size_t count, u8 palette);
+
+    // Converts shades (0-3) to colors of the frame buffer through a table of 4 colors, which are truncated to 16 bits
+    // for the 16-bit overload
+    void applyColors(u16 *pixels, const u8 *shades, size_t count, const u32 (&colors)[4]);
+    void applyColors(u32 *pixels, const u8 *shades, size_t count, const u32 (&colors)[4]);
+
+    // Draws the 8 color indices of an object row onto 8 shades. Transparent pixels are skipped, as well as pixels
+    // where the BG color index is not 0 if the object is behind the BG.
+    void drawObjectRow(u8 *shades, const u8 *bgColorIndexes, const u8 *objColorIndexes, u8 palette, bool behindBG);
+
+}
+
+#endif //FB_CORE_SCANLINE_COMPOSITOR_H
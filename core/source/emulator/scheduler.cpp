@@ -0,0 +1,45 @@
+/**
+ * Copyright 2021 Michel Kremer (kremi151)
+ *
+ * Licensed under the Apache License, Version 2.0 (the License);
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "scheduler.h"
+
+using namespace FunkyBoy;
+
+Scheduler::Scheduler()
+    : cycles(0)
+    , events()
+    , nextEvent(FB_SCHEDULER_NEVER)
+{
+    for (u64 &event : events) {
+        event = FB_SCHEDULER_NEVER;
+    }
+}
+
+void Scheduler::schedule(EventType type, u64 at) {
+    u64 &event = events[static_cast<u8>(type)];
+    bool wasNext = event == nextEvent;
+    event = at;
+    if (at <= nextEvent) {
+        nextEvent = at;
+    } else if (wasNext) {
+        nextEvent = FB_SCHEDULER_NEVER;
+        for (u64 pending : events) {
+            if (pending < nextEvent) {
+                nextEvent = pending;
+            }
+        }
+    }
+}
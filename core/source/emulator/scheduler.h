@@ -0,0 +1,81 @@
+/**
+ * Copyright 2021 Michel Kremer (kremi151)
+ *
+ * Licensed under the Apache License, Version 2.0 (the License);
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FB_CORE_SCHEDULER_H
+#define FB_CORE_SCHEDULER_H
+
+#include <util/typedefs.h>
+
+#define FB_SCHEDULER_NEVER (~static_cast<u64>(0))
+
+namespace FunkyBoy {
+
+    enum class EventType : u8 {
+        // Next PPU mode transition
+        PPU_TRANSITION = 0,
+        // Machine cycle in which the timers request their next interrupt
+        TIMER_INTERRUPT,
+        // Next step of the APU frame sequencer
+        APU_FRAME_SEQUENCER,
+        // Writing back cartridge RAM after it has not been modified for a while
+        AUTOSAVE,
+        COUNT
+    };
+
+    /**
+     * Keeps track of the machine cycles which have passed since power-up and of the cycle at which each kind of event
+     * is due next. As there is at most one pending event per kind, events are kept in a fixed table and only the
+     * earliest one has to be compared against on every tick.
+     */
+    class Scheduler {
+    private:
+        u64 cycles;
+        u64 events[static_cast<u8>(EventType::COUNT)];
+        u64 nextEvent;
+    public:
+        Scheduler();
+
+        inline u64 getCycles() const {
+            return cycles;
+        }
+
+        inline void advance(u32_fast machineCycles) {
+            cycles += machineCycles;
+        }
+
+        inline bool isEventDue() const {
+            return cycles >= nextEvent;
+        }
+
+        inline bool isEventDue(EventType type) const {
+            return cycles >= events[static_cast<u8>(type)];
+        }
+
+        inline u64 getEventCycle(EventType type) const {
+            return events[static_cast<u8>(type)];
+        }
+
+        // Schedules the event at the given absolute machine cycle, replacing the pending one of the same kind
+        void schedule(EventType type, u64 at);
+
+        inline void cancel(EventType type) {
+            schedule(type, FB_SCHEDULER_NEVER);
+        }
+    };
+
+}
+
+#endif //FB_CORE_SCHEDULER_H
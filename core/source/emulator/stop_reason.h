@@ -0,0 +1,47 @@
+/**
+ * Copyright 2021 Michel Kremer (kremi151)
+ *
+ * Licensed under the Apache License, Version 2.0 (the License);
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FB_CORE_STOP_REASON_H
+#define FB_CORE_STOP_REASON_H
+
+#include <util/typedefs.h>
+
+namespace FunkyBoy {
+
+    // Tells why Emulator::runUntil has returned. The reasons are bit flags, so that the conditions to stop at can be
+    // combined into a mask.
+    enum StopReason {
+        STOP_NEW_FRAME = 1 << 0,
+
+        // The CPU is about to execute an instruction at a breakpoint
+        STOP_BREAKPOINT = 1 << 1,
+
+        // A byte has been sent over the serial port
+        STOP_SERIAL_BYTE = 1 << 2,
+
+        // The CPU ran into an illegal opcode, or a compiled block did not match the interpreter in JIT_VERIFY mode.
+        // Emulation always stops in this case, regardless of the mask.
+        STOP_ILLEGAL_OPCODE = 1 << 3,
+
+        // The given number of machine cycles has been emulated
+        STOP_CYCLE_BUDGET = 1 << 4,
+    };
+
+    typedef u8_fast stop_mask;
+
+}
+
+#endif //FB_CORE_STOP_REASON_H
@@ -35,10 +35,24 @@
 
 using namespace FunkyBoy;
 
-#define FB_INTERNAL_RAM_BANK_SIZE (4 * 1024)
-#define FB_INTERNAL_RAM_SIZE (8 * FB_INTERNAL_RAM_BANK_SIZE)
 #define FB_CARTRIDGE_HEADER_SIZE 336
-#define FB_HRAM_SIZE 127
+
+// Calls func with the concrete MBC, so that the calls made on it are resolved statically and can be inlined
+template<typename Func>
+static inline auto visitMBC(MBC &mbc, Func &&func) {
+    switch (mbc.type) {
+        case MBCType::MBC1:
+            return func(static_cast<MBC1&>(mbc));
+        case MBCType::MBC2:
+            return func(static_cast<MBC2&>(mbc));
+        case MBCType::MBC3:
+            return func(static_cast<MBC3&>(mbc));
+        case MBCType::MBC5:
+            return func(static_cast<MBC5&>(mbc));
+        default:
+            return func(static_cast<MBCNone&>(mbc));
+    }
+}
 
 Memory::Memory(
         const io_registers& ioRegisters
@@ -46,6 +60,7 @@ Memory::Memory(
 #ifdef FB_USE_SOUND
         , Sound::APU *apu
 #endif
+        , MemoryState *state
 )
     : ioRegisters(ioRegisters)
     , ppuMemory(ppuMemory)
@@ -54,25 +69,38 @@ Memory::Memory(
 #endif
     , interruptEnableRegister(0)
     , dmaStarted(false)
+    , serialTransferCount(0)
+    , romBanks{0, 1}
+    , romVersion(0)
+    , codeVersion(0)
+    , ramCodeVersion(0)
+    , readPages{}
+    , writePages{}
+    , status(CartridgeStatus::NoROMLoaded)
     , rom(nullptr)
     , cram(nullptr)
     , ramSizeInBytes(0)
-    , status(CartridgeStatus::NoROMLoaded)
+    , romLength(0)
     , mbc(new MBCNone())
 #ifdef FB_USE_AUTOSAVE
     , cartridgeRAMWritten(false)
 #endif
 {
-    internalRam = new u8[FB_INTERNAL_RAM_SIZE]{};
-    hram = new u8[FB_HRAM_SIZE]{};
+    if (state == nullptr) {
+        ownedState = std::make_unique<MemoryState>();
+        state = ownedState.get();
+    }
+    internalRam = state->internalRam;
+    hram = state->hram;
 
     dynamicRamBank = internalRam + FB_INTERNAL_RAM_BANK_SIZE;
+    mapRAMPages();
 }
 
 Memory::~Memory() {
-    delete[] internalRam;
-    delete[] hram;
-    delete[] rom;
+    if (romImage == nullptr) {
+        delete[] rom;
+    }
     delete[] cram;
 }
 
@@ -127,6 +155,7 @@ void Memory::loadROM(std::istream &stream, bool strictSizeCheck) {
     std::cout << "Seeked a length of " << length << std::endl;
 #endif
 
+    // Checked before reading the stream, so that oversized files are not read at all
     size_t maxRomSize = romSizeInBytes(ROMSize::ROM_SIZE_8M);
     if (length > maxRomSize) {
         std::cerr << "ROM size mismatch, seeked " << length
@@ -135,6 +164,32 @@ void Memory::loadROM(std::istream &stream, bool strictSizeCheck) {
         return;
     }
 
+    loadROM(ROMImage::fromStream(stream), strictSizeCheck);
+}
+
+void Memory::loadROM(const ROMImagePtr &image) {
+    loadROM(image, false);
+}
+
+void Memory::loadROM(const ROMImagePtr &image, bool strictSizeCheck) {
+    if (image == nullptr) {
+#ifdef FB_DEBUG
+        fprintf(stderr, "ROM image is not readable\n");
+#endif
+        status = CartridgeStatus::ROMFileNotReadable;
+        return;
+    }
+
+    size_t length = image->getSize();
+
+    size_t maxRomSize = romSizeInBytes(ROMSize::ROM_SIZE_8M);
+    if (length > maxRomSize) {
+        std::cerr << "ROM size mismatch, got " << length
+                  << " bytes, which is more than the maximal supported size of " << maxRomSize << " bytes" << std::endl;
+        status = CartridgeStatus::ROMTooBig;
+        return;
+    }
+
     if (length < FB_CARTRIDGE_HEADER_SIZE) {
 #ifdef FB_DEBUG
         fprintf(stderr, "ROM is smaller than the expected cartridge header\n");
@@ -143,10 +198,7 @@ void Memory::loadROM(std::istream &stream, bool strictSizeCheck) {
         return;
     }
 
-    // First, let's only read the ROM header (0x0000 - 0x014F)
-    std::unique_ptr<u8[]> romBytes = std::make_unique<u8[]>(FB_CARTRIDGE_HEADER_SIZE);
-    stream.read(reinterpret_cast<char *>(romBytes.get()), FB_CARTRIDGE_HEADER_SIZE);
-    auto *header = reinterpret_cast<ROMHeader*>(romBytes.get());
+    auto *header = reinterpret_cast<const ROMHeader*>(image->getData());
 
     auto romSizeType = static_cast<ROMSize>(header->romSize);
     size_t romSize = romSizeInBytes(romSizeType);
@@ -166,13 +218,14 @@ void Memory::loadROM(std::istream &stream, bool strictSizeCheck) {
     }
 #endif
 
-    // Next, let's load the rest of the ROM
-    romLength = std::max(romSize, length);
-    u8 *newRomBytes = new u8[romLength]{};
-    std::memcpy(newRomBytes, romBytes.get(), FB_CARTRIDGE_HEADER_SIZE);
-    romBytes.reset(newRomBytes);
-    header = reinterpret_cast<ROMHeader*>(newRomBytes);
-    stream.read(reinterpret_cast<char*>(newRomBytes) + FB_CARTRIDGE_HEADER_SIZE, length - FB_CARTRIDGE_HEADER_SIZE);
+    // ROMs which are smaller than they claim to be are padded with zeros, which requires a copy of the image
+    ROMImagePtr paddedImage = image;
+    if (romSize > length) {
+        std::unique_ptr<u8[]> paddedBytes(new u8[romSize]{});
+        std::memcpy(paddedBytes.get(), image->getData(), length);
+        paddedImage = ROMImage::fromBuffer(std::move(paddedBytes), romSize);
+        header = reinterpret_cast<const ROMHeader*>(paddedImage->getData());
+    }
 
     RAMSize ramSizeType;
     if (header->ramSize > 0x5) {
@@ -298,11 +351,20 @@ void Memory::loadROM(std::istream &stream, bool strictSizeCheck) {
     std::cout << "RAM size: " << ramSizeInBytes << " bytes (headerValue=" << (header->ramSize % 0xff) << ")" << std::endl;
 #endif
 
-    rom = romBytes.release();
+    if (romImage == nullptr) {
+        delete[] rom;
+    }
+    romImage = paddedImage;
+    // The image is shared and never written to
+    rom = const_cast<u8*>(romImage->getData());
+    romLength = romImage->getSize();
+    romVersion++;
+    updateROMBanks();
+    mapROMPages();
 
     delete[] cram;
     if (ramSizeInBytes > 0) {
-        cram = new u8[ramSizeInBytes];
+        cram = new u8[ramSizeInBytes]{};
     } else {
         cram = nullptr;
     }
@@ -310,6 +372,23 @@ void Memory::loadROM(std::istream &stream, bool strictSizeCheck) {
     status = CartridgeStatus::Loaded;
 }
 
+void Memory::reset(bool keepCartridgeRam) {
+    interruptEnableRegister = 0;
+    dmaMsb = 0;
+    dmaLsb = 0;
+    dmaStarted = false;
+    mbc->reset(keepCartridgeRam);
+    updateROMBanks();
+    invalidateRAMCode();
+    if (!keepCartridgeRam && cram != nullptr) {
+        std::memset(cram, 0, ramSizeInBytes);
+#ifdef FB_USE_AUTOSAVE
+        // The discarded RAM must not overwrite the save file
+        cartridgeRAMWritten = false;
+#endif
+    }
+}
+
 u8 * Memory::releaseROM(size_t *size) {
     if (rom == nullptr) {
         throw Exception::WrongStateException("No ROM is loaded");
@@ -319,7 +398,16 @@ u8 * Memory::releaseROM(size_t *size) {
     }
     status = CartridgeStatus::NoROMLoaded;
     u8 *romPtr = rom;
+    if (romImage != nullptr) {
+        // The image might be shared with other emulators, so the caller receives a copy which it owns
+        romPtr = new u8[romLength];
+        std::memcpy(romPtr, rom, romLength);
+        romImage.reset();
+    }
     rom = nullptr;
+    romLength = 0;
+    romVersion++;
+    mapROMPages();
     return romPtr;
 }
 
@@ -387,17 +475,18 @@ case 0xF7: case 0xF8: case 0xF9: case 0xFA: case 0xFB: case 0xFC: case 0xFD
 #define FB_MEMORY_HRAM_AND_IE \
 case 0xFF
 
-u8 Memory::read8BitsAt(memory_address offset) {
+u8 Memory::read8BitsAtSlowly(memory_address offset) {
     switch ((offset >> 8) & 0xff) {
         FB_MEMORY_CARTRIDGE:
-            return mbc->readFromROMAt(offset, rom);
+            return visitMBC(*mbc, [&](auto &m) { return m.readFromROMAt(offset, rom); });
         FB_MEMORY_VRAM:
+            catchUp();
             return ppuMemory.isVRAMAccessibleFromMMU()
                    ? ppuMemory.getVRAMByte(offset - 0x8000)
                    : 0xFF;
         FB_MEMORY_CARTRIDGE_RAM:
             if (cram != nullptr) {
-                return mbc->readFromRAMAt(offset - 0xA000, cram);
+                return visitMBC(*mbc, [&](auto &m) { return m.readFromRAMAt(offset - 0xA000, cram); });
             } else {
                 return 0xFF;
             }
@@ -412,6 +501,7 @@ u8 Memory::read8BitsAt(memory_address offset) {
             return *(dynamicRamBank + (offset - 0xF000));
         FB_MEMORY_OAM: {
             if (offset < 0xFEA0) {
+                catchUp();
                 return ppuMemory.isOAMAccessibleFromMMU()
                     ? ppuMemory.getOAMByte(offset - 0xFE00)
                     : 0xFF;
@@ -429,6 +519,7 @@ u8 Memory::read8BitsAt(memory_address offset) {
             } else if (offset >= 0xFF80) {
                 return *(hram + (offset - 0xFF80));
             } else {
+                catchUp();
                 return ioRegisters.handleMemoryRead(offset - 0xFF00);
             }
         }
@@ -438,45 +529,60 @@ u8 Memory::read8BitsAt(memory_address offset) {
     }
 }
 
-void Memory::write8BitsTo(memory_address offset, u8 val) {
+void Memory::write8BitsToSlowly(memory_address offset, u8 val) {
     switch ((offset >> 8) & 0xff) {
         FB_MEMORY_CARTRIDGE:
             // Writing to read-only area, so we let it intercept by the MBC
-            mbc->interceptROMWrite(offset, val);
+            visitMBC(*mbc, [&](auto &m) { m.interceptROMWrite(offset, val); });
+            updateROMBanks();
             break;
         FB_MEMORY_VRAM: {
+            catchUp();
             if (ppuMemory.isVRAMAccessibleFromMMU()) {
-                ppuMemory.getVRAMByte(offset - 0x8000) = val;
+                ppuMemory.writeVRAMByte(offset - 0x8000, val);
             }
             break;
         }
         FB_MEMORY_CARTRIDGE_RAM:
 #ifdef FB_USE_AUTOSAVE
-            if (cram != nullptr && mbc->writeToRAMAt(offset - 0xA000, val, cram)) {
+            if (cram != nullptr && visitMBC(*mbc, [&](auto &m) { return m.writeToRAMAt(offset - 0xA000, val, cram); })) {
                 cartridgeRAMWritten = true;
 #else
             if (cram != nullptr) {
-                mbc->writeToRAMAt(offset - 0xA000, val, cram);
+                visitMBC(*mbc, [&](auto &m) { return m.writeToRAMAt(offset - 0xA000, val, cram); });
 #endif
             }
             break;
         FB_MEMORY_INTERNAL_RAM:
+            if (ramCodeMarks.test(offset - 0xC000)) {
+                invalidateRAMCode();
+            }
             *(internalRam + (offset - 0xC000)) = val;
             break;
         FB_MEMORY_INTERNAL_RAM_DYNAMIC:
+            if (ramCodeMarks.test(offset - 0xC000)) {
+                invalidateRAMCode();
+            }
             // TODO: Make this switchable
             *(dynamicRamBank + (offset - 0xD000)) = val;
             break;
         FB_MEMORY_ECHO_RAM:
+            if (ramCodeMarks.test(offset - 0xE000)) {
+                invalidateRAMCode();
+            }
             *(internalRam + (offset - 0xE000)) = val;
             break;
         FB_MEMORY_ECHO_RAM_DYNAMIC:
+            if (ramCodeMarks.test(offset - 0xE000)) {
+                invalidateRAMCode();
+            }
             *(dynamicRamBank + (offset - 0xF000)) = val;
             break;
         FB_MEMORY_OAM: {
             if (offset < 0xFEA0) {
+                catchUp();
                 if (ppuMemory.isOAMAccessibleFromMMU()) {
-                    ppuMemory.getOAMByte(offset - 0xFE00) = val;
+                    ppuMemory.writeOAMByte(offset - 0xFE00, val);
                 }
             } else {
                 // Not usable
@@ -489,10 +595,12 @@ void Memory::write8BitsTo(memory_address offset, u8 val) {
         FB_MEMORY_HRAM_AND_IE: {
             if (offset < 0xFF80) {
                 // IO registers
+                catchUp();
 
                 if (offset == FB_REG_SC) {
                     if (val == 0x81) {
                         serialController->sendByte(read8BitsAt(FB_REG_SB));
+                        serialTransferCount++;
                     }
                 } else if (offset == FB_REG_DMA) {
                     dmaStarted = true;
@@ -506,10 +614,16 @@ void Memory::write8BitsTo(memory_address offset, u8 val) {
 #endif
 
                 ioRegisters.handleMemoryWrite(offset - 0xFF00u, val);
+                if (ioWrittenCallback) {
+                    ioWrittenCallback(offset);
+                }
             } else {
                 if (offset == FB_REG_IE) {
                     interruptEnableRegister = val;
                 } else {
+                    if (ramCodeMarks.test(offset - 0xDF80)) {
+                        invalidateRAMCode();
+                    }
                     *(hram + (offset - 0xFF80)) = val;
                 }
             }
@@ -521,11 +635,65 @@ void Memory::write8BitsTo(memory_address offset, u8 val) {
     }
 }
 
+void Memory::updateROMBanks() {
+    u16 lowerBank = visitMBC(*mbc, [](auto &m) { return m.getROMBank(0x0000); });
+    u16 upperBank = visitMBC(*mbc, [](auto &m) { return m.getROMBank(0x4000); });
+    if (lowerBank != romBanks[0] || upperBank != romBanks[1]) {
+        romBanks[0] = lowerBank;
+        romBanks[1] = upperBank;
+        codeVersion++;
+        mapROMPages();
+    }
+}
+
+void Memory::mapROMPages() {
+    // Pages are only mapped if they lie within the ROM, everything else is left to the MBC
+    for (u16_fast page = 0x00; page <= 0x7F; page++) {
+        size_t romOffset = romBanks[page >> 6] * 0x4000 + (page & 0x3Fu) * 0x100;
+        readPages[page] = rom != nullptr && romOffset + 0x100 <= romLength ? rom + romOffset : nullptr;
+    }
+}
+
+void Memory::markRAMCode(memory_address offset, memory_address length) {
+    // Internal RAM is marked at indices 0x0000-0x1FFF, HRAM at indices 0x2000-0x207E
+    memory_address index = offset >= 0xFF80 ? offset - 0xDF80 : offset - 0xC000;
+    unmapRAMPages(index, length);
+    while (length-- > 0) {
+        ramCodeMarks.set(index++);
+    }
+}
+
+void Memory::invalidateRAMCode() {
+    ramCodeMarks.reset();
+    codeVersion++;
+    ramCodeVersion++;
+    mapRAMPages();
+}
+
+void Memory::unmapRAMPages(memory_address index, memory_address length) {
+    // Writes to internal RAM pages containing marked code have to take the slow path, HRAM always takes it anyway
+    for (memory_address page = index >> 8; page < 0x20 && (page << 8) < index + length; page++) {
+        writePages[0xC0 + page] = nullptr;
+        if (page < 0x1E) {
+            writePages[0xE0 + page] = nullptr;
+        }
+    }
+}
+
+void Memory::mapRAMPages() {
+    for (u16_fast page = 0xC0; page <= 0xFD; page++) {
+        u8 *ptr = internalRam + ((page - 0xC0) & 0x1Fu) * 0x100;
+        readPages[page] = ptr;
+        writePages[page] = ptr;
+    }
+}
+
 void Memory::doDMA() {
     if (!dmaStarted) {
         return;
     }
-    ppuMemory.getOAMByte(dmaLsb) = read8BitsAt(Util::compose16Bits(dmaLsb, dmaMsb));
+    catchUp();
+    ppuMemory.writeOAMByte(dmaLsb, read8BitsAt(Util::compose16Bits(dmaLsb, dmaMsb)));
     if (++dmaLsb > 0x9F) {
         dmaStarted = false;
     }
@@ -567,6 +735,8 @@ void Memory::deserialize(std::istream &istream) {
     status = static_cast<CartridgeStatus>(buffer[4]);
 
     mbc->deserialize(istream);
+    updateROMBanks();
+    invalidateRAMCode();
 
     uint64_t ramSizeInBytes = Util::Stream::read64Bits(istream);
 
@@ -587,6 +757,43 @@ void Memory::deserialize(std::istream &istream) {
     this->ramSizeInBytes = ramSizeInBytes;
 }
 
+void Memory::saveSnapshot(Snapshot::Writer &writer) const {
+    // The type of the MBC comes first, so that it can be checked before anything is restored
+    writer.write(mbc->type);
+    writer.write(interruptEnableRegister);
+    writer.write(dmaLsb);
+    writer.write(dmaMsb);
+    writer.write(dmaStarted);
+    mbc->saveSnapshot(writer);
+    if (ramSizeInBytes > 0) {
+        writer.writeBytes(cram, ramSizeInBytes);
+    }
+}
+
+void Memory::checkSnapshot(Snapshot::Reader reader) const {
+    MBCType mbcType;
+    reader.read(mbcType);
+    if (mbcType != mbc->type) {
+        throw Exception::ReadException("Snapshot was taken with another type of cartridge");
+    }
+}
+
+void Memory::loadSnapshot(Snapshot::Reader &reader) {
+    checkSnapshot(reader);
+    MBCType mbcType;
+    reader.read(mbcType);
+    reader.read(interruptEnableRegister);
+    reader.read(dmaLsb);
+    reader.read(dmaMsb);
+    reader.read(dmaStarted);
+    mbc->loadSnapshot(reader);
+    updateROMBanks();
+    invalidateRAMCode();
+    if (ramSizeInBytes > 0) {
+        reader.readBytes(cram, ramSizeInBytes);
+    }
+}
+
 #ifdef FB_TESTING
 
 io_registers& Memory::getIoRegisters() {
@@ -24,6 +24,7 @@
 #include <emulator/io_registers.h>
 #include <memory/ppu_memory.h>
 #include <cartridge/mbc.h>
+#include <cartridge/rom_image.h>
 #include <operands/debug.h>
 
 #ifdef FB_USE_SOUND
@@ -31,10 +32,21 @@
 #endif
 
 #include <iostream>
+#include <functional>
+#include <bitset>
 #include <cartridge/header.h>
 
+#define FB_INTERNAL_RAM_BANK_SIZE (4 * 1024)
+#define FB_INTERNAL_RAM_SIZE (8 * FB_INTERNAL_RAM_BANK_SIZE)
+#define FB_HRAM_SIZE 127
+
 namespace FunkyBoy {
 
+    struct MemoryState {
+        u8 hram[FB_HRAM_SIZE]{};
+        u8 internalRam[FB_INTERNAL_RAM_SIZE]{};
+    };
+
     class Memory : public Reconfigurable {
     private:
         Controller::SerialControllerPtr serialController;
@@ -46,6 +58,8 @@ namespace FunkyBoy {
         Sound::APU *apu;
 #endif
 
+        // Only set if the state is not owned by the caller
+        std::unique_ptr<MemoryState> ownedState;
         u8 *internalRam;
         u8 *hram;
         u8 interruptEnableRegister;
@@ -53,11 +67,40 @@ namespace FunkyBoy {
         u8 dmaMsb{}, dmaLsb{};
         bool dmaStarted;
 
+        u32 serialTransferCount;
+
+        std::function<void(bool)> catchUpCallback;
+        std::function<void(memory_address)> ioWrittenCallback;
+
+        // State used to keep cached code in sync with memory
+        u16 romBanks[2];
+        u32 romVersion;
+        u32 codeVersion;
+        u32 ramCodeVersion;
+        std::bitset<0x2000 + 0x7F> ramCodeMarks;
+
+        // Host pointers to the 256 byte pages of the address space which can be accessed directly, or nullptr for
+        // pages which have to go through read8BitsAtSlowly / write8BitsToSlowly
+        u8 *readPages[0x100];
+        u8 *writePages[0x100];
+
+        void updateROMBanks();
+        void mapROMPages();
+        void invalidateRAMCode();
+        void unmapRAMPages(memory_address index, memory_address length);
+        void mapRAMPages();
+
+        u8 read8BitsAtSlowly(memory_address offset);
+        void write8BitsToSlowly(memory_address offset, u8 val);
+
         CartridgeStatus status;
 
         // Do not free these pointers, they are proxies to the ones above:
         u8 *dynamicRamBank;
 
+        // Backs rom if set, otherwise rom is owned by this class
+        ROMImagePtr romImage;
+
     test_public:
         u8 *rom;
         u8 *cram;
@@ -73,6 +116,7 @@ namespace FunkyBoy {
 #ifdef FB_USE_SOUND
                 , Sound::APU *apu
 #endif
+                , MemoryState *state = nullptr
         );
         ~Memory();
 
@@ -83,29 +127,115 @@ namespace FunkyBoy {
 
         void onControllersUpdated(const Controller::Controllers &controllers) override;
 
+        // The callback is invoked before I/O registers, VRAM or OAM are accessed, so that components which are
+        // allowed to lag behind the CPU can catch up first. The parameter tells whether the caller is only interested
+        // in pending interrupt requests.
+        inline void setCatchUpCallback(std::function<void(bool)> callback) {
+            catchUpCallback = std::move(callback);
+        }
+
+        // The callback is invoked after an I/O register has been written, so that events depending on it can be
+        // scheduled again
+        inline void setIOWrittenCallback(std::function<void(memory_address)> callback) {
+            ioWrittenCallback = std::move(callback);
+        }
+
+        inline void catchUp() {
+            if (catchUpCallback) {
+                catchUpCallback(false);
+            }
+        }
+
+        inline void catchUpInterrupts() {
+            if (catchUpCallback) {
+                catchUpCallback(true);
+            }
+        }
+
         void loadROM(std::istream &stream);
         void loadROM(std::istream &stream, bool strictSizeCheck);
+        void loadROM(const ROMImagePtr &image);
+        void loadROM(const ROMImagePtr &image, bool strictSizeCheck);
+
+        // Returns the image of the loaded ROM, which can be passed to loadROM of other instances to share it
+        inline const ROMImagePtr &getROMImage() const {
+            return romImage;
+        }
 
         void loadRam(std::istream &stream);
         void writeRam(std::ostream &stream);
 
+        // Resets the memory controller and the cartridge to their power-up state while keeping the ROM loaded.
+        // Internal RAM and HRAM are part of the MachineState and have to be reset along with it.
+        void reset(bool keepCartridgeRam);
+
         inline size_t getCartridgeRamSize() {
             return ramSizeInBytes;
         }
 
+        inline size_t getROMLength() const {
+            return romLength;
+        }
+
         const ROMHeader *getROMHeader();
         CartridgeStatus getCartridgeStatus();
 
-        u8 read8BitsAt(memory_address offset);
+        inline u8 read8BitsAt(memory_address offset) {
+            // Addresses past 0xFFFF can result from 16-bit arithmetic and are left to the slow path
+            const u8 *page = readPages[(offset >> 8) & 0xff];
+            if (page != nullptr && offset <= 0xFFFF) {
+                return page[offset & 0xff];
+            }
+            return read8BitsAtSlowly(offset);
+        }
 
         inline i8 readSigned8BitsAt(memory_address offset) {
             return static_cast<i8>(read8BitsAt(offset));
         }
 
-        void write8BitsTo(memory_address offset, u8 val);
+        inline void write8BitsTo(memory_address offset, u8 val) {
+            u8 *page = writePages[(offset >> 8) & 0xff];
+            if (page != nullptr && offset <= 0xFFFF) {
+                page[offset & 0xff] = val;
+            } else {
+                write8BitsToSlowly(offset, val);
+            }
+        }
 
         void doDMA();
 
+        inline bool isDMAActive() const {
+            return dmaStarted;
+        }
+
+        // Returns the ROM bank which is currently mapped to the given address (0x0000-0x7FFF)
+        inline u16 getROMBank(memory_address offset) const {
+            return romBanks[(offset >> 14) & 0b1u];
+        }
+
+        // Changes whenever a different ROM has been loaded
+        inline u32 getROMVersion() const {
+            return romVersion;
+        }
+
+        // Changes whenever ROM banks have been switched or code in RAM might have been overwritten
+        inline u32 getCodeVersion() const {
+            return codeVersion;
+        }
+
+        // Only changes whenever code in RAM might have been overwritten
+        inline u32 getRAMCodeVersion() const {
+            return ramCodeVersion;
+        }
+
+        // Marks code in internal RAM or HRAM, so that the code versions change as soon as it is overwritten
+        void markRAMCode(memory_address offset, memory_address length);
+
+        // Number of bytes which have been sent over the serial port so far
+        inline u32 getSerialTransferCount() const {
+            return serialTransferCount;
+        }
+
         inline u8 getIE() {
             return interruptEnableRegister;
         }
@@ -115,6 +245,13 @@ namespace FunkyBoy {
         void serialize(std::ostream &ostream) const;
         void deserialize(std::istream &istream);
 
+        // Internal RAM and HRAM are not part of the snapshot, they are captured along with the MachineState
+        void saveSnapshot(Snapshot::Writer &writer) const;
+        void loadSnapshot(Snapshot::Reader &reader);
+        // Throws a ReadException if the snapshot at the position of the reader cannot be loaded, without changing
+        // any state
+        void checkSnapshot(Snapshot::Reader reader) const;
+
 #ifdef FB_DEBUG_WRITE_EXECUTION_LOG
         inline void getMBCDebugInfo(const char **outName, unsigned &outRomBank) {
             mbc->getDebugInfo(outName, outRomBank);
@@ -20,56 +20,78 @@
 
 using namespace FunkyBoy;
 
-#define FB_VRAM_BYTES 8192
-#define FB_OAM_BYTES 160
-
 PPUMemory::PPUMemory()
-    : vram(new u8[FB_VRAM_BYTES]{})
-    , oam(new u8[FB_OAM_BYTES]{})
-    , vramAccessible(new bool(true))
-    , oamAccessible(new bool(true))
+    : state(new PPUMemoryState())
     , ptrCounter(new u16(1))
+    , cache(std::make_shared<PPUMemoryCache>())
+{
+    invalidateCache();
+}
+
+PPUMemory::PPUMemory(PPUMemoryState &state)
+    : state(&state)
+    , ptrCounter(nullptr)
+    , cache(std::make_shared<PPUMemoryCache>())
 {
+    invalidateCache();
 }
 
 PPUMemory::PPUMemory(const PPUMemory &other)
-    : vram(other.vram)
-    , oam(other.oam)
-    , vramAccessible(other.vramAccessible)
-    , oamAccessible(other.oamAccessible)
+    : state(other.state)
     , ptrCounter(other.ptrCounter)
+    , cache(other.cache)
 {
-    (*ptrCounter)++;
+    if (ptrCounter != nullptr) {
+        (*ptrCounter)++;
+    }
 }
 
 PPUMemory::~PPUMemory() {
-    if (--(*ptrCounter) < 1) {
-        delete[] vram;
-        delete[] oam;
-        delete vramAccessible;
-        delete oamAccessible;
+    if (ptrCounter != nullptr && --(*ptrCounter) < 1) {
+        delete state;
         delete ptrCounter;
     }
 }
 
 void PPUMemory::setAccessibilityFromMMU(bool accessVram, bool accessOam) {
-    *vramAccessible = accessVram;
-    *oamAccessible = accessOam;
+    state->vramAccessible = accessVram;
+    state->oamAccessible = accessOam;
+}
+
+void PPUMemory::decodeTile(u16_fast tileIndex) {
+    const u8 *tileData = state->vram + tileIndex * 16;
+    for (u8_fast row = 0 ; row < 8 ; row++) {
+        const u8 lsb = tileData[row * 2];
+        const u8 msb = tileData[row * 2 + 1];
+        u8 *regular = cache->tileRows[0][tileIndex][row];
+        u8 *flipped = cache->tileRows[1][tileIndex][row];
+        for (u8_fast x = 0 ; x < 8 ; x++) {
+            const u8 colorIndex = ((lsb >> (7 - x)) & 1u) | (((msb >> (7 - x)) & 1u) << 1);
+            regular[x] = colorIndex;
+            flipped[7 - x] = colorIndex;
+        }
+    }
+    cache->dirtyTiles[tileIndex] = false;
+}
+
+void PPUMemory::invalidateCache() {
+    cache->dirtyTiles.set();
+    cache->oamChanged = true;
 }
 
 void PPUMemory::serialize(std::ostream &ostream) const {
-    ostream.write(reinterpret_cast<const char*>(vram), FB_VRAM_BYTES);
-    ostream.write(reinterpret_cast<const char*>(oam), FB_OAM_BYTES);
-    ostream.put(*vramAccessible);
-    ostream.put(*oamAccessible);
+    ostream.write(reinterpret_cast<const char*>(state->vram), FB_VRAM_BYTES);
+    ostream.write(reinterpret_cast<const char*>(state->oam), FB_OAM_BYTES);
+    ostream.put(state->vramAccessible);
+    ostream.put(state->oamAccessible);
 }
 
 void PPUMemory::deserialize(std::istream &istream) {
-    istream.read(reinterpret_cast<char*>(vram), FB_VRAM_BYTES);
+    istream.read(reinterpret_cast<char*>(state->vram), FB_VRAM_BYTES);
     if (!istream) {
         throw Exception::ReadException("Stream is too short (Video RAM)");
     }
-    istream.read(reinterpret_cast<char*>(oam), FB_OAM_BYTES);
+    istream.read(reinterpret_cast<char*>(state->oam), FB_OAM_BYTES);
     if (!istream) {
         throw Exception::ReadException("Stream is too short (OAM)");
     }
@@ -80,6 +102,8 @@ void PPUMemory::deserialize(std::istream &istream) {
         throw Exception::ReadException("Stream is too short (PPU Memory)");
     }
 
-    *vramAccessible = buffer[0] != 0;
-    *oamAccessible = buffer[1] != 0;
+    state->vramAccessible = buffer[0] != 0;
+    state->oamAccessible = buffer[1] != 0;
+
+    invalidateCache();
 }
\ No newline at end of file
@@ -18,44 +18,99 @@
 #define FB_CORE_MEMORY_PPU_MEMORY_H
 
 #include <util/typedefs.h>
-#include <util/endianness.h>
 
 #include <iostream>
+#include <memory>
+#include <bitset>
+
+#define FB_VRAM_BYTES 8192
+#define FB_OAM_BYTES 160
+// Number of tiles in the tile data at 0x8000-0x97FF
+#define FB_TILE_COUNT 384
 
 namespace FunkyBoy {
 
+    struct PPUMemoryState {
+        u8 vram[FB_VRAM_BYTES]{};
+        u8 oam[FB_OAM_BYTES]{};
+        bool vramAccessible = true;
+        bool oamAccessible = true;
+    };
+
+    /**
+     * Data which is derived from the VRAM and the OAM and therefore not part of the PPUMemoryState
+     */
+    struct PPUMemoryCache {
+        // Color indices of every tile, decoded from the 2 bits per pixel in VRAM, in regular and horizontally flipped
+        // order
+        u8 tileRows[2][FB_TILE_COUNT][8][8];
+        // Tiles which have been written to since they have been decoded
+        std::bitset<FB_TILE_COUNT> dirtyTiles;
+        bool oamChanged;
+    };
+
     class PPUMemory {
     private:
-        u8 *vram;
-        u8 *oam;
-        bool *vramAccessible;
-        bool *oamAccessible;
+        PPUMemoryState *state;
+        // Shared by all copies, only set if the state is owned by them
         u16 *ptrCounter;
+        // Shared by all copies
+        std::shared_ptr<PPUMemoryCache> cache;
+
+        void decodeTile(u16_fast tileIndex);
     public:
         PPUMemory();
+        // Uses state which is owned by the caller
+        explicit PPUMemory(PPUMemoryState &state);
         PPUMemory(const PPUMemory &other);
         ~PPUMemory();
 
         PPUMemory &operator=(const PPUMemory &other) = delete;
 
-        inline u8 &getVRAMByte(memory_address vramOffset) {
-            return *(vram + vramOffset);
+        inline u8 getVRAMByte(memory_address vramOffset) const {
+            return *(state->vram + vramOffset);
         }
 
-        inline u16 readVRAM16Bits(memory_address vramOffset) {
-            return Util::compose16Bits(*(vram + vramOffset), *(vram + vramOffset + 1));
+        inline void writeVRAMByte(memory_address vramOffset, u8 val) {
+            *(state->vram + vramOffset) = val;
+            if (vramOffset < FB_TILE_COUNT * 16) {
+                cache->dirtyTiles[vramOffset / 16] = true;
+            }
         }
 
+        // Returns the 8 color indices of a row of a tile (0-383), which is decoded first if it has been written to
+        inline const u8 *getDecodedTileRow(u16_fast tileIndex, u8_fast row, bool flipX) {
+            if (cache->dirtyTiles[tileIndex]) {
+                decodeTile(tileIndex);
+            }
+            return cache->tileRows[flipX][tileIndex][row];
+        }
+
+        // Has to be called after VRAM and OAM have been overwritten as a whole, e.g. when a state has been restored
+        void invalidateCache();
+
         [[nodiscard]] inline bool isVRAMAccessibleFromMMU() const {
-            return *vramAccessible;
+            return state->vramAccessible;
+        }
+
+        inline u8 getOAMByte(memory_address oamOffset) const {
+            return *(state->oam + oamOffset);
+        }
+
+        inline void writeOAMByte(memory_address oamOffset, u8 val) {
+            *(state->oam + oamOffset) = val;
+            cache->oamChanged = true;
         }
 
-        inline u8 &getOAMByte(memory_address oamOffset) {
-            return *(oam + oamOffset);
+        // Returns whether the OAM has been written to since the last call
+        inline bool clearOAMChanged() {
+            const bool changed = cache->oamChanged;
+            cache->oamChanged = false;
+            return changed;
         }
 
         [[nodiscard]] inline bool isOAMAccessibleFromMMU() const {
-            return *oamAccessible;
+            return state->oamAccessible;
         }
 
         void setAccessibilityFromMMU(bool accessVram, bool accessOam);
@@ -18,14 +18,77 @@
 #define FB_CORE_OPERANDS_ALU_H
 
 #include <operands/instruction_context.h>
+#include <util/flags.h>
 
 namespace FunkyBoy::Operands {
 
+    inline void __alu_adc(InstrContext &context, u8 val, bool carry) {
+        u8 &regA = context.registers[REG_A];
+        u8 carryVal = carry ? 1 : 0;
+        context.updateFlags(Flags::FLAGS_ADD, regA, val, carryVal);
+        regA += val + carryVal;
+    }
+
+    inline void __alu_sbc(InstrContext &context, u8 val, bool carry) {
+        u8 &regA = context.registers[REG_A];
+        u8 carryVal = carry ? 1 : 0;
+        context.updateFlags(Flags::FLAGS_SUB, regA, val, carryVal);
+        regA -= val + carryVal;
+    }
+
+    inline void __alu_addToHL(InstrContext &context, u16 val) {
+        u16 oldVal = context.readHL();
+        u16 newVal = oldVal + val;
+
+        context.materializeFlags();
+        Flags::setFlags(context.regF, Flags::isZero(context.regF), false, ((oldVal & 0xfff) + (val & 0xfff)) > 0xfff, (oldVal & 0xffff) + (val & 0xffff) > 0xffff);
+
+        context.writeHL(newVal);
+    }
+
+    inline void __alu_cp(InstrContext &context, u8 val) {
+        // See http://z80-heaven.wikidot.com/instructions-set:cp
+        context.updateFlags(Flags::FLAGS_SUB, context.registers[REG_A], val);
+    }
+
+    inline void __alu_or(InstrContext &context, u8 val) {
+        context.registers[REG_A] |= val;
+        context.updateFlags(Flags::FLAGS_OR, context.registers[REG_A]);
+    }
+
+    inline void __alu_and(InstrContext &context, u8 val) {
+        context.registers[REG_A] &= val;
+        context.updateFlags(Flags::FLAGS_AND, context.registers[REG_A]);
+    }
+
+    inline void __alu_xor(InstrContext &context, u8 val) {
+        context.registers[REG_A] ^= val;
+        context.updateFlags(Flags::FLAGS_OR, context.registers[REG_A]);
+    }
+
+    inline void __alu_inc(InstrContext &context, u8 &val) {
+        val++;
+        // Carry is left as-is, so it has to be known before
+        context.materializeFlags();
+        context.updateFlags(Flags::FLAGS_INC, val);
+    }
+
+    inline void __alu_dec(InstrContext &context, u8 &val) {
+        val--;
+        // Carry is left as-is, so it has to be known before
+        context.materializeFlags();
+        context.updateFlags(Flags::FLAGS_DEC, val);
+    }
+
     /**
      * ADD A,r
      * @param context
      */
-    bool add_A_r(InstrContext &context, Memory &memory);
+    template<Register reg>
+    bool add_A_r(InstrContext &context, Memory &memory) {
+        __alu_adc(context, context.registers[reg], false);
+        return true;
+    }
 
     /**
      * ADD A,d
@@ -37,7 +100,12 @@ namespace FunkyBoy::Operands {
      * ADC A,r
      * @param context
      */
-    bool adc_A_r(InstrContext &context, Memory &memory);
+    template<Register reg>
+    bool adc_A_r(InstrContext &context, Memory &memory) {
+        context.materializeFlags();
+        __alu_adc(context, context.registers[reg], Flags::isCarry(context.regF));
+        return true;
+    }
 
     /**
      * ADC A,d
@@ -49,7 +117,11 @@ namespace FunkyBoy::Operands {
      * ADD HL,ss
      * @param context
      */
-    bool add_HL_ss(InstrContext &context, Memory &memory);
+    template<RegisterPair pair>
+    bool add_HL_ss(InstrContext &context, Memory &memory) {
+        __alu_addToHL(context, context.read16BitRegister(pair));
+        return true;
+    }
 
     /**
      * ADD HL,SP
@@ -79,7 +151,11 @@ namespace FunkyBoy::Operands {
      * SUB A,r
      * @param context
      */
-    bool sub_A_r(InstrContext &context, Memory &memory);
+    template<Register reg>
+    bool sub_A_r(InstrContext &context, Memory &memory) {
+        __alu_sbc(context, context.registers[reg], false);
+        return true;
+    }
 
     /**
      * SUB A,d
@@ -91,7 +167,12 @@ namespace FunkyBoy::Operands {
      * SBC A,r
      * @param context
      */
-    bool sbc_A_r(InstrContext &context, Memory &memory);
+    template<Register reg>
+    bool sbc_A_r(InstrContext &context, Memory &memory) {
+        context.materializeFlags();
+        __alu_sbc(context, context.registers[reg], Flags::isCarry(context.regF));
+        return true;
+    }
 
     /**
      * SBC A,d
@@ -115,7 +196,11 @@ namespace FunkyBoy::Operands {
      * CP r
      * @param context
      */
-    bool cp_r(InstrContext &context, Memory &memory);
+    template<Register reg>
+    bool cp_r(InstrContext &context, Memory &memory) {
+        __alu_cp(context, context.registers[reg]);
+        return true;
+    }
 
     /**
      * CP d
@@ -133,7 +218,11 @@ namespace FunkyBoy::Operands {
      * INC ss
      * @param context
      */
-    bool inc_ss(InstrContext &context, Memory &memory);
+    template<RegisterPair pair>
+    bool inc_ss(InstrContext &context, Memory &memory) {
+        context.write16BitRegister(pair, context.read16BitRegister(pair) + 1);
+        return true;
+    }
 
     /**
      * INC SP
@@ -151,13 +240,21 @@ namespace FunkyBoy::Operands {
      * INC r
      * @param context
      */
-    bool inc_r(InstrContext &context, Memory &memory);
+    template<Register reg>
+    bool inc_r(InstrContext &context, Memory &memory) {
+        __alu_inc(context, context.registers[reg]);
+        return true;
+    }
 
     /**
      * DEC ss
      * @param context
      */
-    bool dec_ss(InstrContext &context, Memory &memory);
+    template<RegisterPair pair>
+    bool dec_ss(InstrContext &context, Memory &memory) {
+        context.write16BitRegister(pair, context.read16BitRegister(pair) - 1);
+        return true;
+    }
 
     /**
      * DEC SP
@@ -175,13 +272,21 @@ namespace FunkyBoy::Operands {
      * DEC r
      * @param context
      */
-    bool dec_r(InstrContext &context, Memory &memory);
+    template<Register reg>
+    bool dec_r(InstrContext &context, Memory &memory) {
+        __alu_dec(context, context.registers[reg]);
+        return true;
+    }
 
     /**
      * OR r
      * @param context
      */
-    bool or_r(InstrContext &context, Memory &memory);
+    template<Register reg>
+    bool or_r(InstrContext &context, Memory &memory) {
+        __alu_or(context, context.registers[reg]);
+        return true;
+    }
 
     /**
      * OR d
@@ -199,7 +304,11 @@ namespace FunkyBoy::Operands {
      * AND r
      * @param context
      */
-    bool and_r(InstrContext &context, Memory &memory);
+    template<Register reg>
+    bool and_r(InstrContext &context, Memory &memory) {
+        __alu_and(context, context.registers[reg]);
+        return true;
+    }
 
     /**
      * AND d
@@ -217,7 +326,11 @@ namespace FunkyBoy::Operands {
      * XOR r
      * @param context
      */
-    bool xor_r(InstrContext &context, Memory &memory);
+    template<Register reg>
+    bool xor_r(InstrContext &context, Memory &memory) {
+        __alu_xor(context, context.registers[reg]);
+        return true;
+    }
 
     /**
      * XOR d
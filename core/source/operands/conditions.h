@@ -18,24 +18,35 @@
 #define FB_CORE_OPERANDS_CONDITIONS_H
 
 #include <operands/instruction_context.h>
+#include <util/flags.h>
 
 namespace FunkyBoy::Operands {
 
     /**
-     * Checks whether zero flag is not set if opcode is in left half of the table (0xX0 - 0xX7), otherwise whether it is set.
-     * If not set, the next opcode will be fetched in the next machine cycle, skipping remaining operands.
+     * Checks whether zero flag matches {@code expected}. Opcodes in the left half of the table (0xX0 - 0xX7) expect it
+     * not to be set, opcodes in the right half expect it to be set.
+     * If it does not match, the next opcode will be fetched in the next machine cycle, skipping remaining operands.
      * @param context
      * @return
      */
-    bool checkIsZeroContextual(InstrContext &context, Memory &memory);
+    template<bool expected>
+    bool checkIsZero(InstrContext &context, Memory &memory) {
+        context.materializeFlags();
+        return Flags::isZero(context.regF) == expected;
+    }
 
     /**
-     * Checks whether carry flag is not set if opcode is in left half of the table (0xX0 - 0xX7), otherwise whether it is set.
-     * If not set, the next opcode will be fetched in the next machine cycle, skipping remaining operands.
+     * Checks whether carry flag matches {@code expected}. Opcodes in the left half of the table (0xX0 - 0xX7) expect it
+     * not to be set, opcodes in the right half expect it to be set.
+     * If it does not match, the next opcode will be fetched in the next machine cycle, skipping remaining operands.
      * @param context
      * @return
      */
-    bool checkIsCarryContextual(InstrContext &context, Memory &memory);
+    template<bool expected>
+    bool checkIsCarry(InstrContext &context, Memory &memory) {
+        context.materializeFlags();
+        return Flags::isCarry(context.regF) == expected;
+    }
 
 }
 
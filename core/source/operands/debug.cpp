@@ -24,6 +24,7 @@
 using namespace FunkyBoy;
 
 void Debug::writeExecutionToLog(uint8_t discriminator, std::ofstream &file, FunkyBoy::InstrContext &instrContext, FunkyBoy::Memory &memory) {
+    instrContext.materializeFlags();
     file << discriminator << " ";
     file << "0x" << std::uppercase << std::setfill('0') << std::setw(2) << std::hex << (instrContext.instr & 0xff);
     file << " B=0x" << std::uppercase << std::setfill('0') << std::setw(2) << std::hex << (*instrContext.regB & 0xff);
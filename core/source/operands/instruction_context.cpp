@@ -24,6 +24,7 @@ using namespace FunkyBoy;
 
 InstrContext::InstrContext(FunkyBoy::GameBoyType gbType)
     : gbType(gbType)
+    , immediates(nullptr)
 {
     regB = registers;
     regC = registers + 1;
@@ -58,21 +59,17 @@ void InstrContext::writeHL(u16 val) {
     *regH = (val >> 8u) & 0xffu;
 }
 
-void InstrContext::write16BitRegister(u8 position, u16 val) {
-    u8 *reg = registers + (position * 2);
-    *reg = (val >> 8u) & 0xffu;
-    *(reg + 1) = val & 0xffu;
-}
-
-u16 InstrContext::read16BitRegister(u8 position) {
-    u8 *reg = registers + (position * 2);
-    return (*reg << 8u) | (*(reg + 1u) & 0xffu);
-}
-
 void InstrContext::serialize(std::ostream &ostream) const {
     ostream.put(instr);
     ostream.put(cbInstr);
+#ifdef FB_USE_LAZY_FLAGS
+    u8 values[8];
+    std::memcpy(values, registers, sizeof(values));
+    Flags::applyOperation(values + REG_F, lazyFlags.operation, lazyFlags.a, lazyFlags.b, lazyFlags.carry);
+    ostream.write(reinterpret_cast<const char*>(values), 8);
+#else
     ostream.write(reinterpret_cast<const char*>(registers), 8);
+#endif
     ostream.put(lsb);
     ostream.put(msb);
     ostream.put(signedByte);
@@ -92,6 +89,9 @@ void InstrContext::deserialize(std::istream &istream) {
     instr = buffer[0];
     cbInstr = buffer[1];
     std::memcpy(registers, buffer + 2, 8);
+#ifdef FB_USE_LAZY_FLAGS
+    lazyFlags.operation = Flags::FLAGS_NONE;
+#endif
     lsb = buffer[10];
     msb = buffer[11];
     signedByte = buffer[12];
@@ -100,4 +100,40 @@ void InstrContext::deserialize(std::istream &istream) {
     haltBugRequested = buffer[15] != 0;
     progCounter = Util::Stream::read16Bits(istream);
     stackPointer = Util::Stream::read16Bits(istream);
+    immediates = nullptr;
+}
+
+void InstrContext::saveSnapshot(Snapshot::Writer &writer) const {
+    writer.write(instr);
+    writer.write(cbInstr);
+    writer.write(registers);
+    writer.write(lsb);
+    writer.write(msb);
+    writer.write(signedByte);
+    writer.write(progCounter);
+    writer.write(stackPointer);
+    writer.write(cpuState);
+    writer.write(interruptMasterEnable);
+    writer.write(haltBugRequested);
+#ifdef FB_USE_LAZY_FLAGS
+    writer.write(lazyFlags);
+#endif
+}
+
+void InstrContext::loadSnapshot(Snapshot::Reader &reader) {
+    reader.read(instr);
+    reader.read(cbInstr);
+    reader.read(registers);
+    reader.read(lsb);
+    reader.read(msb);
+    reader.read(signedByte);
+    reader.read(progCounter);
+    reader.read(stackPointer);
+    reader.read(cpuState);
+    reader.read(interruptMasterEnable);
+    reader.read(haltBugRequested);
+#ifdef FB_USE_LAZY_FLAGS
+    reader.read(lazyFlags);
+#endif
+    immediates = nullptr;
 }
\ No newline at end of file
@@ -18,6 +18,8 @@
 #define FB_CORE_OPERANDS_CONTEXT_H
 
 #include <util/typedefs.h>
+#include <util/flags.h>
+#include <util/snapshot.h>
 #include <memory/memory.h>
 #include <emulator/gb_type.h>
 #include <operands/debug.h>
@@ -38,6 +40,25 @@ namespace FunkyBoy {
         STOPPED = 2
     };
 
+    // Indexes of the 8 bit registers within InstrContext::registers, as they are encoded in opcodes
+    enum Register : u8 {
+        REG_B = 0,
+        REG_C = 1,
+        REG_D = 2,
+        REG_E = 3,
+        REG_H = 4,
+        REG_L = 5,
+        REG_F = 6,
+        REG_A = 7
+    };
+
+    // Indexes of the 16 bit registers within InstrContext::registers, as they are encoded in opcodes
+    enum RegisterPair : u8 {
+        REG_BC = 0,
+        REG_DE = 1,
+        REG_HL = 2
+    };
+
     class InstrContext;
 
     typedef bool (*Operand)(InstrContext &context, Memory &memory);
@@ -48,8 +69,8 @@ namespace FunkyBoy {
 
         const GameBoyType gbType;
 
-        u8 instr;
-        u8 cbInstr;
+        u8 instr{};
+        u8 cbInstr{};
         u8 registers[8]{};
 
         // Do not free these pointers, they are proxies to specific locations in the registers array
@@ -64,9 +85,9 @@ namespace FunkyBoy {
 
         const Operand **operandsPtr;
 
-        u8 lsb;
-        u8 msb;
-        i8 signedByte;
+        u8 lsb{};
+        u8 msb{};
+        i8 signedByte{};
 
         u16 progCounter;
         u16 stackPointer;
@@ -76,6 +97,23 @@ namespace FunkyBoy {
 
         bool haltBugRequested;
 
+#ifdef FB_USE_LAZY_FLAGS
+        // Last flag affecting ALU operation whose result has not been written into register F yet
+        Flags::LazyFlags lazyFlags{};
+#endif
+
+        // Points to the predecoded immediate bytes of the current instruction, or nullptr if they have to be read
+        // from memory
+        const u8 *immediates;
+
+        inline u8 readImmediate(Memory &memory) {
+            if (immediates != nullptr) {
+                progCounter++;
+                return *(immediates++);
+            }
+            return memory.read8BitsAt(progCounter++);
+        }
+
         /* inline */ u16 readHL() {
             return (*regL & 0xffu) | (*regH << 8u);
         }
@@ -86,12 +124,47 @@ namespace FunkyBoy {
         void push16Bits(Memory &memory, u8 msb, u8 lsb);
         u16 pop16Bits(Memory &memory);
 
-        void write16BitRegister(u8 position, u16 val);
-        u16 read16BitRegister(u8 position);
+        inline void write16BitRegister(u8 position, u16 val) {
+            u8 *reg = registers + (position * 2);
+            *reg = (val >> 8u) & 0xffu;
+            *(reg + 1) = val & 0xffu;
+        }
+
+        inline u16 read16BitRegister(u8 position) {
+            u8 *reg = registers + (position * 2);
+            return (*reg << 8u) | (*(reg + 1u) & 0xffu);
+        }
+
+        /**
+         * Updates the flags after an ALU operation. With lazy flags, the operation is only recorded and register F
+         * is computed once it is read by {@code materializeFlags}.
+         */
+        inline void updateFlags(Flags::FlagsOperation operation, u8 a, u8 b = 0, u8 carry = 0) {
+#ifdef FB_USE_LAZY_FLAGS
+            lazyFlags = {operation, a, b, carry};
+#else
+            Flags::applyOperation(regF, operation, a, b, carry);
+#endif
+        }
+
+        /**
+         * Has to be called before register F is read or partially written.
+         */
+        inline void materializeFlags() {
+#ifdef FB_USE_LAZY_FLAGS
+            if (lazyFlags.operation != Flags::FLAGS_NONE) {
+                Flags::applyOperation(regF, lazyFlags.operation, lazyFlags.a, lazyFlags.b, lazyFlags.carry);
+                lazyFlags.operation = Flags::FLAGS_NONE;
+            }
+#endif
+        }
 
         void serialize(std::ostream &ostream) const;
         void deserialize(std::istream &istream);
 
+        void saveSnapshot(Snapshot::Writer &writer) const;
+        void loadSnapshot(Snapshot::Reader &reader);
+
 #ifdef FB_DEBUG_WRITE_EXECUTION_LOG
         std::ofstream *executionLog;
 #endif
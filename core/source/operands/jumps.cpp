@@ -54,12 +54,4 @@ bool Operands::call(InstrContext &context, Memory &memory) {
 bool Operands::ret(InstrContext &context, Memory &memory) {
     context.progCounter = context.pop16Bits(memory);
     return true;
-}
-
-bool Operands::rst(InstrContext &context, Memory &memory) {
-    u8 rstAddr = (context.instr >> 3u & 7u) * 8u;
-    debug_print_4("rst %02XH\n", rstAddr);
-    context.push16Bits(memory, context.progCounter);
-    context.progCounter = rstAddr;
-    return true;
 }
\ No newline at end of file
@@ -18,6 +18,7 @@
 #define FB_CORE_OPERANDS_JUMPS_H
 
 #include <operands/instruction_context.h>
+#include <util/debug.h>
 
 namespace FunkyBoy::Operands {
 
@@ -30,7 +31,13 @@ namespace FunkyBoy::Operands {
 
     bool ret(InstrContext &context, Memory &memory);
 
-    bool rst(InstrContext &context, Memory &memory);
+    template<u8 address>
+    bool rst(InstrContext &context, Memory &memory) {
+        debug_print_4("rst %02XH\n", address);
+        context.push16Bits(memory, context.progCounter);
+        context.progCounter = address;
+        return true;
+    }
 
 }
 
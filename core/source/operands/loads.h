@@ -19,13 +19,19 @@
 
 #include "instruction_context.h"
 
+#include <util/endianness.h>
+
 namespace FunkyBoy::Operands {
 
     /**
      * LD r,r
      * @param context
      */
-    bool load_r_r(InstrContext &context, Memory &memory);
+    template<Register dst, Register src>
+    bool load_r_r(InstrContext &context, Memory &memory) {
+        context.registers[dst] = context.registers[src];
+        return true;
+    }
 
     /**
      * LD (dd),A
@@ -49,7 +55,11 @@ namespace FunkyBoy::Operands {
      * LD dd,nn
      * @param context
      */
-    bool load_dd_nn(InstrContext &context, Memory &memory);
+    template<RegisterPair pair>
+    bool load_dd_nn(InstrContext &context, Memory &memory) {
+        context.write16BitRegister(pair, Util::compose16Bits(context.lsb, context.msb));
+        return true;
+    }
 
     /**
      * LD SP,nn
@@ -66,7 +76,11 @@ namespace FunkyBoy::Operands {
     /**
      * LD r,n
      */
-    bool load_r_n(InstrContext &context, Memory &memory);
+    template<Register reg>
+    bool load_r_n(InstrContext &context, Memory &memory) {
+        context.registers[reg] = context.lsb;
+        return true;
+    }
 
     /**
      * LD (HL),n
@@ -78,13 +92,21 @@ namespace FunkyBoy::Operands {
      * LD (dd),A
      * @param context
      */
-    bool load_reg_dd_A(InstrContext &context, Memory &memory);
+    template<RegisterPair pair>
+    bool load_reg_dd_A(InstrContext &context, Memory &memory) {
+        memory.write8BitsTo(context.read16BitRegister(pair), context.registers[REG_A]);
+        return true;
+    }
 
     /**
      * LD A,(dd)
      * @param context
      */
-    bool load_A_reg_dd(InstrContext &context, Memory &memory);
+    template<RegisterPair pair>
+    bool load_A_reg_dd(InstrContext &context, Memory &memory) {
+        context.registers[REG_A] = memory.read8BitsAt(context.read16BitRegister(pair));
+        return true;
+    }
 
     /**
      * LD (HL+),A
@@ -114,13 +136,21 @@ namespace FunkyBoy::Operands {
      * LD (HL),r
      * @param context
      */
-    bool load_HL_r(InstrContext &context, Memory &memory);
+    template<Register reg>
+    bool load_HL_r(InstrContext &context, Memory &memory) {
+        memory.write8BitsTo(context.readHL(), context.registers[reg]);
+        return true;
+    }
 
     /**
      * LD r,(HL)
      * @param context
      */
-    bool load_r_HL(InstrContext &context, Memory &memory);
+    template<Register reg>
+    bool load_r_HL(InstrContext &context, Memory &memory) {
+        context.registers[reg] = memory.read8BitsAt(context.readHL());
+        return true;
+    }
 
     /**
      * LD SP,HL
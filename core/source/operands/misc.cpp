@@ -65,6 +65,7 @@ bool Operands::halt(InstrContext &context, Memory &memory) {
 }
 
 bool Operands::daa(InstrContext &context, Memory &memory) {
+    context.materializeFlags();
     u8 val = *context.regA;
     if (Flags::isSubstraction(context.regF)) {
         if (Flags::isCarry(context.regF)) {
@@ -89,6 +90,7 @@ bool Operands::daa(InstrContext &context, Memory &memory) {
 }
 
 bool Operands::cpl(InstrContext &context, Memory &memory) {
+    context.materializeFlags();
     *context.regA = ~*context.regA;
     Flags::setSubstraction(context.regF, true);
     Flags::setHalfCarry(context.regF, true);
@@ -96,11 +98,13 @@ bool Operands::cpl(InstrContext &context, Memory &memory) {
 }
 
 bool Operands::scf(InstrContext &context, Memory &memory) {
+    context.materializeFlags();
     Flags::setFlags(context.regF, Flags::isZero(context.regF), false, false, true);
     return true;
 }
 
 bool Operands::ccf(InstrContext &context, Memory &memory) {
+    context.materializeFlags();
     Flags::setFlags(context.regF, Flags::isZero(context.regF), false, false, !Flags::isCarry(context.regF));
     return true;
 }
@@ -16,22 +16,20 @@
 
 #include "reads.h"
 
-#include <util/registers.h>
-
 using namespace FunkyBoy;
 
 bool Operands::readLSB(InstrContext &context, Memory &memory) {
-    context.lsb = memory.read8BitsAt(context.progCounter++);
+    context.lsb = context.readImmediate(memory);
     return true;
 }
 
 bool Operands::readMSB(InstrContext &context, Memory &memory) {
-    context.msb = memory.read8BitsAt(context.progCounter++);
+    context.msb = context.readImmediate(memory);
     return true;
 }
 
 bool Operands::readSigned(InstrContext &context, Memory &memory) {
-    context.signedByte = memory.readSigned8BitsAt(context.progCounter++);
+    context.signedByte = static_cast<i8>(context.readImmediate(memory));
     return true;
 }
 
@@ -42,25 +40,11 @@ bool Operands::readRegCAsLSB(InstrContext &context, Memory &memory) {
 }
 
 bool Operands::readMemAsLSB(InstrContext &context, Memory &memory) {
-    context.lsb = memory.read8BitsAt(context.progCounter++);
+    context.lsb = context.readImmediate(memory);
     context.msb = 0xFF;
     return true;
 }
 
-bool Operands::readRRLSBIntoStack(InstrContext &context, Memory &memory) {
-    u8 *reg = Util::decodeRRAddressFromOpcode(context.registers, context.instr) + 1;
-    context.stackPointer--;
-    memory.write8BitsTo(context.stackPointer, *reg);
-    return true;
-}
-
-bool Operands::readRRMSBIntoStack(InstrContext &context, Memory &memory) {
-    u8 *reg = Util::decodeRRAddressFromOpcode(context.registers, context.instr);
-    context.stackPointer--;
-    memory.write8BitsTo(context.stackPointer, *reg);
-    return true;
-}
-
 bool Operands::readStackIntoLSB(InstrContext &context, Memory &memory) {
     context.lsb = memory.read8BitsAt(context.stackPointer++);
     return true;
@@ -78,6 +62,7 @@ bool Operands::readRegAIntoStack(InstrContext &context, Memory &memory) {
 }
 
 bool Operands::readRegFIntoStack(InstrContext &context, Memory &memory) {
+    context.materializeFlags();
     context.stackPointer--;
     memory.write8BitsTo(context.stackPointer, *context.regF);
     return true;
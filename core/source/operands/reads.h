@@ -57,7 +57,12 @@ namespace FunkyBoy::Operands {
      * @param context
      * @return
      */
-    bool readRRLSBIntoStack(InstrContext &context, Memory &memory);
+    template<RegisterPair pair>
+    bool readRRLSBIntoStack(InstrContext &context, Memory &memory) {
+        context.stackPointer--;
+        memory.write8BitsTo(context.stackPointer, context.registers[pair * 2 + 1]);
+        return true;
+    }
 
     /**
      * Decrements SP (SP--) first, then reads MSB(rr) into memory pointed by SP.
@@ -65,7 +70,12 @@ namespace FunkyBoy::Operands {
      * @param context
      * @return
      */
-    bool readRRMSBIntoStack(InstrContext &context, Memory &memory);
+    template<RegisterPair pair>
+    bool readRRMSBIntoStack(InstrContext &context, Memory &memory) {
+        context.stackPointer--;
+        memory.write8BitsTo(context.stackPointer, context.registers[pair * 2]);
+        return true;
+    }
 
     /**
      * Reads memory pointed by SP into {@code lsb}, then increments SP (SP++).
@@ -23,10 +23,6 @@ namespace FunkyBoy::Operands::Registry {
             Operands::nop,
             nullptr
     };
-    const Operand ld_r_r[2] = {
-            Operands::load_r_r,
-            nullptr
-    };
     const Operand ld_a16_A[5] = {
             Operands::readLSB,
             Operands::readMSB,
@@ -56,12 +52,6 @@ namespace FunkyBoy::Operands::Registry {
             Operands::load_A_d,
             nullptr
     };
-    const Operand ld_ss_d16[4] = {
-            Operands::readLSB,
-            Operands::readMSB,
-            Operands::load_dd_nn,
-            nullptr
-    };
     const Operand ld_SP_d16[4] = {
             Operands::readLSB,
             Operands::readMSB,
@@ -78,27 +68,12 @@ namespace FunkyBoy::Operands::Registry {
             Operands::load_nn_SP,
             nullptr
     };
-    const Operand ld_r_d8[3] = {
-            Operands::readLSB,
-            Operands::load_r_n,
-            nullptr
-    };
     const Operand ld_HL_d8[4] = {
             Operands::readLSB,
             Operands::_pad_, // TODO: do something useful here
             Operands::load_HL_n,
             nullptr
     };
-    const Operand ld_ss_A[3] = {
-            Operands::_pad_, // TODO: do something useful here
-            Operands::load_reg_dd_A,
-            nullptr
-    };
-    const Operand ld_A_ss[3] = {
-            Operands::_pad_, // TODO: do something useful here
-            Operands::load_A_reg_dd,
-            nullptr
-    };
     const Operand ld_HLI_A[3] = {
             Operands::_pad_, // TODO: do something useful here
             Operands::load_HLI_A,
@@ -119,16 +94,6 @@ namespace FunkyBoy::Operands::Registry {
             Operands::load_A_HLD,
             nullptr
     };
-    const Operand ld_HL_r[3] = {
-            Operands::_pad_, // TODO: do something useful here
-            Operands::load_HL_r,
-            nullptr
-    };
-    const Operand ld_r_HL[3] = {
-            Operands::_pad_, // TODO: do something useful here
-            Operands::load_r_HL,
-            nullptr
-    };
     const Operand ld_SP_HL[3] = {
             Operands::_pad_, // TODO: do something useful here
             Operands::load_SP_HL,
@@ -153,14 +118,6 @@ namespace FunkyBoy::Operands::Registry {
             nullptr
     };
 
-    const Operand add_A_r[2] = {
-            Operands::add_A_r,
-            nullptr
-    };
-    const Operand adc_A_r[2] = {
-            Operands::adc_A_r,
-            nullptr
-    };
     const Operand add_A_d8[3] = {
             Operands::readLSB,
             Operands::add_A_d,
@@ -171,11 +128,6 @@ namespace FunkyBoy::Operands::Registry {
             Operands::adc_A_d,
             nullptr
     };
-    const Operand add_HL_ss[3] = {
-            Operands::_pad_, // TODO: do something useful here
-            Operands::add_HL_ss,
-            nullptr
-    };
     const Operand add_HL_SP[3] = {
             Operands::_pad_, // TODO: do something useful here,
             Operands::add_HL_SP,
@@ -201,14 +153,6 @@ namespace FunkyBoy::Operands::Registry {
             nullptr
     };
 
-    const Operand sub_A_r[2] = {
-            Operands::sub_A_r,
-            nullptr
-    };
-    const Operand sbc_A_r[2] = {
-            Operands::sbc_A_r,
-            nullptr
-    };
     const Operand sub_A_d8[3] = {
             Operands::readLSB,
             Operands::sub_A_d,
@@ -230,20 +174,6 @@ namespace FunkyBoy::Operands::Registry {
             nullptr
     };
 
-    const Operand jp_N_Z_a16[5] = {
-            Operands::readLSB,
-            Operands::readMSB,
-            Operands::checkIsZeroContextual,
-            Operands::jp,
-            nullptr
-    };
-    const Operand jp_N_C_a16[5] = {
-            Operands::readLSB,
-            Operands::readMSB,
-            Operands::checkIsCarryContextual,
-            Operands::jp,
-            nullptr
-    };
     const Operand jp[5] = {
             Operands::readLSB,
             Operands::readMSB,
@@ -256,18 +186,6 @@ namespace FunkyBoy::Operands::Registry {
             nullptr
     };
 
-    const Operand jr_N_Z_r8[4] = {
-            Operands::readSigned,
-            Operands::checkIsZeroContextual,
-            Operands::jr,
-            nullptr
-    };
-    const Operand jr_N_C_r8[4] = {
-            Operands::readSigned,
-            Operands::checkIsCarryContextual,
-            Operands::jr,
-            nullptr
-    };
     const Operand jr[4] = {
             Operands::readSigned,
             Operands::_pad_,
@@ -275,28 +193,6 @@ namespace FunkyBoy::Operands::Registry {
             nullptr
     };
 
-    const Operand call_N_Z_a16[7] = {
-            Operands::readLSB,
-            Operands::readMSB,
-            Operands::checkIsZeroContextual,
-            // Pad artificially to 6 machine cycles TODO: do something useful here
-            Operands::_pad_,
-            Operands::_pad_,
-            //
-            Operands::call,
-            nullptr
-    };
-    const Operand call_N_C_a16[7] = {
-            Operands::readLSB,
-            Operands::readMSB,
-            Operands::checkIsCarryContextual,
-            // Pad artificially to 6 machine cycles TODO: do something useful here
-            Operands::_pad_,
-            Operands::_pad_,
-            //
-            Operands::call,
-            nullptr
-    };
     const Operand call_a16[7] = {
             Operands::readLSB,
             Operands::readMSB,
@@ -309,24 +205,6 @@ namespace FunkyBoy::Operands::Registry {
             nullptr
     };
 
-    const Operand ret_N_Z[6] = {
-            // Pad artificially to 5 machine cycles TODO: do something useful here
-            Operands::_pad_, // This has to happen before the ret condition (unmet condition -> 2 M cycles)
-            Operands::checkIsZeroContextual,
-            Operands::_pad_,
-            Operands::_pad_,
-            Operands::ret,
-            nullptr
-    };
-    const Operand ret_N_C[6] = {
-            // Pad artificially to 5 machine cycles TODO: do something useful here
-            Operands::_pad_, // This has to happen before the ret condition (unmet condition -> 2 M cycles)
-            Operands::checkIsCarryContextual,
-            Operands::_pad_,
-            Operands::_pad_,
-            Operands::ret,
-            nullptr
-    };
     const Operand ret[5] = {
             // Pad artificially to 4 machine cycles TODO: do something useful here
             Operands::_pad_,
@@ -346,20 +224,7 @@ namespace FunkyBoy::Operands::Registry {
             nullptr
     };
 
-    const Operand rst_vec[5] = {
-            // Pad artificially to 4 machine cycles TODO: do something useful here
-            Operands::_pad_,
-            Operands::_pad_,
-            Operands::_pad_,
-            //
-            Operands::rst,
-            nullptr
-    };
 
-    const Operand cp_r[2] = {
-            Operands::cp_r,
-            nullptr
-    };
     const Operand cp_HL[3] = {
             Operands::_pad_, // TODO: do something useful here
             Operands::cp_HL,
@@ -371,11 +236,6 @@ namespace FunkyBoy::Operands::Registry {
             nullptr
     };
 
-    const Operand inc_ss[3] = {
-            Operands::_pad_, // TODO: do something useful here
-            Operands::inc_ss,
-            nullptr
-    };
     const Operand inc_SP[3] = {
             Operands::_pad_, // TODO: do something useful here
             Operands::inc_SP,
@@ -389,16 +249,7 @@ namespace FunkyBoy::Operands::Registry {
             Operands::inc_HL,
             nullptr
     };
-    const Operand inc_r[2] = {
-            Operands::inc_r,
-            nullptr
-    };
 
-    const Operand dec_ss[3] = {
-            Operands::_pad_, // TODO: do something useful here
-            Operands::dec_ss,
-            nullptr
-    };
     const Operand dec_SP[3] = {
             Operands::_pad_, // TODO: do something useful here
             Operands::dec_SP,
@@ -412,15 +263,7 @@ namespace FunkyBoy::Operands::Registry {
             Operands::dec_HL,
             nullptr
     };
-    const Operand dec_r[2] = {
-            Operands::dec_r,
-            nullptr
-    };
 
-    const Operand or_r[2] = {
-            Operands::or_r,
-            nullptr
-    };
     const Operand or_HL[3] = {
             Operands::_pad_, // TODO: do something useful here
             Operands::or_HL,
@@ -432,10 +275,6 @@ namespace FunkyBoy::Operands::Registry {
             nullptr
     };
 
-    const Operand and_r[2] = {
-            Operands::and_r,
-            nullptr
-    };
     const Operand and_HL[3] = {
             Operands::_pad_, // TODO: do something useful here
             Operands::and_HL,
@@ -447,10 +286,6 @@ namespace FunkyBoy::Operands::Registry {
             nullptr
     };
 
-    const Operand xor_r[2] = {
-            Operands::xor_r,
-            nullptr
-    };
     const Operand xor_HL[3] = {
             Operands::_pad_, // TODO: do something useful here
             Operands::xor_HL,
@@ -482,12 +317,6 @@ namespace FunkyBoy::Operands::Registry {
             nullptr
     };
 
-    const Operand pop_rr[4] = {
-            Operands::readStackIntoLSB,
-            Operands::readStackIntoMSB,
-            Operands::write16BitsIntoRR,
-            nullptr
-    };
     const Operand pop_AF[4] = {
             Operands::readStackIntoLSB,
             Operands::readStackIntoMSB,
@@ -495,13 +324,6 @@ namespace FunkyBoy::Operands::Registry {
             nullptr
     };
 
-    const Operand push_rr[5] = {
-            Operands::_pad_, // TODO: do something useful here
-            Operands::readRRMSBIntoStack,
-            Operands::readRRLSBIntoStack,
-            Operands::_pad_, // TODO: do something useful here
-            nullptr
-    };
     const Operand push_AF[5] = {
             Operands::_pad_, // TODO: do something useful here
             Operands::readRegAIntoStack,
@@ -553,7 +375,7 @@ namespace FunkyBoy::Operands::Registry {
     const Operand decodePrefix[3] = {
             Operands::decodePrefix,
             // This is a workaround, the decodePrefix operand will fetch the effective operand list to use
-            // When changing this, please also adapt CPU::serialize and CPU::deserialize
+            // When changing this, please also adapt CPU::getOperandIndex and CPU::setOperandIndex
             Operands::prefixPlaceholder,
             nullptr
     };
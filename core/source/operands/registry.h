@@ -18,94 +18,260 @@
 #define FB_CORE_OPERANDS_REGISTRY_H
 
 #include <operands/instruction_context.h>
+#include <operands/instructions.h>
 
 namespace FunkyBoy::Operands::Registry {
     extern const Operand nop[2];
-    extern const Operand ld_r_r[2];
+    template<Register dst, Register src>
+    inline const Operand ld_r_r[2] = {
+        Operands::load_r_r<dst, src>,
+        nullptr
+    };
     extern const Operand ld_a16_A[5];
     extern const Operand ld_A_a16[5];
     extern const Operand ld_C_A[3];
     extern const Operand ld_A_C[3];
     extern const Operand ld_A_d8[3];
-    extern const Operand ld_ss_d16[4];
+    template<RegisterPair pair>
+    inline const Operand ld_ss_d16[4] = {
+        Operands::readLSB,
+        Operands::readMSB,
+        Operands::load_dd_nn<pair>,
+        nullptr
+    };
     extern const Operand ld_SP_d16[4];
     extern const Operand ld_a16_SP[6];
-    extern const Operand ld_r_d8[3];
+    template<Register reg>
+    inline const Operand ld_r_d8[3] = {
+        Operands::readLSB,
+        Operands::load_r_n<reg>,
+        nullptr
+    };
     extern const Operand ld_HL_d8[4];
-    extern const Operand ld_ss_A[3];
-    extern const Operand ld_A_ss[3];
+    template<RegisterPair pair>
+    inline const Operand ld_ss_A[3] = {
+        Operands::_pad_, // TODO: do something useful here
+        Operands::load_reg_dd_A<pair>,
+        nullptr
+    };
+    template<RegisterPair pair>
+    inline const Operand ld_A_ss[3] = {
+        Operands::_pad_, // TODO: do something useful here
+        Operands::load_A_reg_dd<pair>,
+        nullptr
+    };
     extern const Operand ld_HLI_A[3];
     extern const Operand ld_HLD_A[3];
     extern const Operand ld_A_HLI[3];
     extern const Operand ld_A_HLD[3];
-    extern const Operand ld_HL_r[3];
-    extern const Operand ld_r_HL[3];
+    template<Register reg>
+    inline const Operand ld_HL_r[3] = {
+        Operands::_pad_, // TODO: do something useful here
+        Operands::load_HL_r<reg>,
+        nullptr
+    };
+    template<Register reg>
+    inline const Operand ld_r_HL[3] = {
+        Operands::_pad_, // TODO: do something useful here
+        Operands::load_r_HL<reg>,
+        nullptr
+    };
     extern const Operand ld_SP_HL[3];
     extern const Operand ld_HL_SP_e8[4];
     extern const Operand ldh_a8_A[4];
     extern const Operand ldh_A_a8[4];
 
-    extern const Operand add_A_r[2];
-    extern const Operand adc_A_r[2];
+    template<Register reg>
+    inline const Operand add_A_r[2] = {
+        Operands::add_A_r<reg>,
+        nullptr
+    };
+    template<Register reg>
+    inline const Operand adc_A_r[2] = {
+        Operands::adc_A_r<reg>,
+        nullptr
+    };
     extern const Operand add_A_d8[3];
     extern const Operand adc_A_d8[3];
-    extern const Operand add_HL_ss[3];
+    template<RegisterPair pair>
+    inline const Operand add_HL_ss[3] = {
+        Operands::_pad_, // TODO: do something useful here
+        Operands::add_HL_ss<pair>,
+        nullptr
+    };
     extern const Operand add_HL_SP[3];
     extern const Operand add_SP_r8[5];
     extern const Operand add_A_HL[3];
     extern const Operand adc_A_HL[3];
 
-    extern const Operand sub_A_r[2];
-    extern const Operand sbc_A_r[2];
+    template<Register reg>
+    inline const Operand sub_A_r[2] = {
+        Operands::sub_A_r<reg>,
+        nullptr
+    };
+    template<Register reg>
+    inline const Operand sbc_A_r[2] = {
+        Operands::sbc_A_r<reg>,
+        nullptr
+    };
     extern const Operand sub_A_d8[3];
     extern const Operand sbc_A_d8[3];
     extern const Operand sub_HL[3];
     extern const Operand sbc_HL[3];
 
-    extern const Operand jp_N_Z_a16[5];
-    extern const Operand jp_N_C_a16[5];
+    template<bool expected>
+    inline const Operand jp_N_Z_a16[5] = {
+        Operands::readLSB,
+        Operands::readMSB,
+        Operands::checkIsZero<expected>,
+        Operands::jp,
+        nullptr
+    };
+    template<bool expected>
+    inline const Operand jp_N_C_a16[5] = {
+        Operands::readLSB,
+        Operands::readMSB,
+        Operands::checkIsCarry<expected>,
+        Operands::jp,
+        nullptr
+    };
     extern const Operand jp[5];
     extern const Operand jp_HL[2];
 
-    extern const Operand jr_N_Z_r8[4];
-    extern const Operand jr_N_C_r8[4];
+    template<bool expected>
+    inline const Operand jr_N_Z_r8[4] = {
+        Operands::readSigned,
+        Operands::checkIsZero<expected>,
+        Operands::jr,
+        nullptr
+    };
+    template<bool expected>
+    inline const Operand jr_N_C_r8[4] = {
+        Operands::readSigned,
+        Operands::checkIsCarry<expected>,
+        Operands::jr,
+        nullptr
+    };
     extern const Operand jr[4];
 
-    extern const Operand call_N_Z_a16[7];
-    extern const Operand call_N_C_a16[7];
+    template<bool expected>
+    inline const Operand call_N_Z_a16[7] = {
+        Operands::readLSB,
+        Operands::readMSB,
+        Operands::checkIsZero<expected>,
+        // Pad artificially to 6 machine cycles TODO: do something useful here
+        Operands::_pad_,
+        Operands::_pad_,
+        //
+        Operands::call,
+        nullptr
+    };
+    template<bool expected>
+    inline const Operand call_N_C_a16[7] = {
+        Operands::readLSB,
+        Operands::readMSB,
+        Operands::checkIsCarry<expected>,
+        // Pad artificially to 6 machine cycles TODO: do something useful here
+        Operands::_pad_,
+        Operands::_pad_,
+        //
+        Operands::call,
+        nullptr
+    };
     extern const Operand call_a16[7];
 
-    extern const Operand ret_N_Z[6];
-    extern const Operand ret_N_C[6];
+    template<bool expected>
+    inline const Operand ret_N_Z[6] = {
+        // Pad artificially to 5 machine cycles TODO: do something useful here
+        Operands::_pad_, // This has to happen before the ret condition (unmet condition -> 2 M cycles)
+        Operands::checkIsZero<expected>,
+        Operands::_pad_,
+        Operands::_pad_,
+        Operands::ret,
+        nullptr
+    };
+    template<bool expected>
+    inline const Operand ret_N_C[6] = {
+        // Pad artificially to 5 machine cycles TODO: do something useful here
+        Operands::_pad_, // This has to happen before the ret condition (unmet condition -> 2 M cycles)
+        Operands::checkIsCarry<expected>,
+        Operands::_pad_,
+        Operands::_pad_,
+        Operands::ret,
+        nullptr
+    };
     extern const Operand ret[5];
 
     extern const Operand reti[5];
 
-    extern const Operand rst_vec[5];
-
-    extern const Operand cp_r[2];
+    template<u8 address>
+    inline const Operand rst_vec[5] = {
+        // Pad artificially to 4 machine cycles TODO: do something useful here
+        Operands::_pad_,
+        Operands::_pad_,
+        Operands::_pad_,
+        //
+        Operands::rst<address>,
+        nullptr
+    };
+
+    template<Register reg>
+    inline const Operand cp_r[2] = {
+        Operands::cp_r<reg>,
+        nullptr
+    };
     extern const Operand cp_HL[3];
     extern const Operand cp_d8[3];
 
-    extern const Operand inc_ss[3];
+    template<RegisterPair pair>
+    inline const Operand inc_ss[3] = {
+        Operands::_pad_, // TODO: do something useful here
+        Operands::inc_ss<pair>,
+        nullptr
+    };
     extern const Operand inc_SP[3];
     extern const Operand inc_HL[4];
-    extern const Operand inc_r[2];
-
-    extern const Operand dec_ss[3];
+    template<Register reg>
+    inline const Operand inc_r[2] = {
+        Operands::inc_r<reg>,
+        nullptr
+    };
+
+    template<RegisterPair pair>
+    inline const Operand dec_ss[3] = {
+        Operands::_pad_, // TODO: do something useful here
+        Operands::dec_ss<pair>,
+        nullptr
+    };
     extern const Operand dec_SP[3];
     extern const Operand dec_HL[4];
-    extern const Operand dec_r[2];
-
-    extern const Operand or_r[2];
+    template<Register reg>
+    inline const Operand dec_r[2] = {
+        Operands::dec_r<reg>,
+        nullptr
+    };
+
+    template<Register reg>
+    inline const Operand or_r[2] = {
+        Operands::or_r<reg>,
+        nullptr
+    };
     extern const Operand or_HL[3];
     extern const Operand or_d8[3];
 
-    extern const Operand and_r[2];
+    template<Register reg>
+    inline const Operand and_r[2] = {
+        Operands::and_r<reg>,
+        nullptr
+    };
     extern const Operand and_HL[3];
     extern const Operand and_d8[3];
 
-    extern const Operand xor_r[2];
+    template<Register reg>
+    inline const Operand xor_r[2] = {
+        Operands::xor_r<reg>,
+        nullptr
+    };
     extern const Operand xor_HL[3];
     extern const Operand xor_d8[3];
 
@@ -117,10 +283,23 @@ namespace FunkyBoy::Operands::Registry {
 
     extern const Operand rla[2];
 
-    extern const Operand pop_rr[4];
+    template<RegisterPair pair>
+    inline const Operand pop_rr[4] = {
+        Operands::readStackIntoLSB,
+        Operands::readStackIntoMSB,
+        Operands::write16BitsIntoRR<pair>,
+        nullptr
+    };
     extern const Operand pop_AF[4];
 
-    extern const Operand push_rr[5];
+    template<RegisterPair pair>
+    inline const Operand push_rr[5] = {
+        Operands::_pad_, // TODO: do something useful here
+        Operands::readRRMSBIntoStack<pair>,
+        Operands::readRRLSBIntoStack<pair>,
+        Operands::_pad_, // TODO: do something useful here
+        nullptr
+    };
     extern const Operand push_AF[5];
 
     extern const Operand daa[2];
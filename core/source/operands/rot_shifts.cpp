@@ -21,6 +21,7 @@
 using namespace FunkyBoy;
 
 bool Operands::rrca(InstrContext &context, Memory &memory) {
+    context.materializeFlags();
     u8 a = *context.regA;
     *context.regA = (a >> 1) | ((a & 1) << 7);
     Flags::setFlags(context.regF, false, false, false, a & 1u);
@@ -28,6 +29,7 @@ bool Operands::rrca(InstrContext &context, Memory &memory) {
 }
 
 bool Operands::rlca(InstrContext &context, Memory &memory) {
+    context.materializeFlags();
     u8 a = *context.regA;
     *context.regA = (a << 1) | ((a & 128) >> 7);
     Flags::setFlags(context.regF, false, false, false, (a & 128u) != 0);
@@ -35,6 +37,7 @@ bool Operands::rlca(InstrContext &context, Memory &memory) {
 }
 
 bool Operands::rra(InstrContext &context, Memory &memory) {
+    context.materializeFlags();
     u8 a = *context.regA;
     *context.regA = a >> 1;
     if (Flags::isCarry(context.regF)) {
@@ -45,6 +48,7 @@ bool Operands::rra(InstrContext &context, Memory &memory) {
 }
 
 bool Operands::rla(InstrContext &context, Memory &memory) {
+    context.materializeFlags();
     u8 a = *context.regA;
     *context.regA = a << 1;
     if (Flags::isCarry(context.regF)) {
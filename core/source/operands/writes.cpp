@@ -16,18 +16,10 @@
 
 #include "writes.h"
 
-#include <util/registers.h>
-
 using namespace FunkyBoy;
 
-bool Operands::write16BitsIntoRR(InstrContext &context, Memory &memory) {
-    u8 *reg = Util::decodeRRAddressFromOpcode(context.registers, context.instr);
-    *reg = context.msb;
-    *(reg + 1) = context.lsb;
-    return true;
-}
-
 bool Operands::write16BitsIntoAF(InstrContext &context, Memory &memory) {
+    context.materializeFlags();
     *context.regA = context.msb;
     *context.regF = context.lsb & 0b11110000u; // Only store 4 most significant bits into register F
     return true;
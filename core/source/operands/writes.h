@@ -23,11 +23,15 @@ namespace FunkyBoy::Operands {
 
     /**
      * Writes 16 bits composed by {@code lsb} and {@code msb} into 16bit register.
-     * The 16bit register is determined by reading bits 4 and 5 of the current {@code instr}.
      * @param context
      * @return
      */
-    bool write16BitsIntoRR(InstrContext &context, Memory &memory);
+    template<RegisterPair pair>
+    bool write16BitsIntoRR(InstrContext &context, Memory &memory) {
+        context.registers[pair * 2] = context.msb;
+        context.registers[pair * 2 + 1] = context.lsb;
+        return true;
+    }
 
     /**
      * Writes 16 bits composed by {@code lsb} and {@code msb} into AF register
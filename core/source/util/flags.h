@@ -47,6 +47,59 @@ namespace FunkyBoy::Flags {
 
     void setZero(u8 *flags, bool zero);
 
+    /**
+     * Flag affecting operations of the ALU which can be replayed from their operands.
+     * The logical operations and INC/DEC are recorded with their result.
+     */
+    enum FlagsOperation : u8 {
+        FLAGS_NONE = 0,
+        FLAGS_ADD = 1,
+        FLAGS_SUB = 2,
+        FLAGS_AND = 3,
+        FLAGS_OR = 4,
+        FLAGS_INC = 5,
+        FLAGS_DEC = 6
+    };
+
+    struct LazyFlags {
+        FlagsOperation operation;
+        u8 a;
+        u8 b;
+        u8 carry;
+    };
+
+    inline void applyOperation(u8 *flags, FlagsOperation operation, u8 a, u8 b, u8 carry) {
+        switch (operation) {
+            case FLAGS_ADD:
+                setFlags(flags, static_cast<u8>(a + b + carry) == 0, false, ((a & 0xf) + (b & 0xf) + carry) > 0xf, a + b + carry > 0xff);
+                break;
+            case FLAGS_SUB:
+                setFlags(flags, static_cast<u8>(a - b - carry) == 0, true, (a & 0xf) - (b & 0xf) - carry < 0, a < (b + carry));
+                break;
+            case FLAGS_AND:
+                //TODO: To be verified:
+                setFlags(flags, a == 0, false, true, false);
+                break;
+            case FLAGS_OR:
+                setFlags(flags, a == 0, false, false, false);
+                break;
+            case FLAGS_INC:
+                setZero(flags, a == 0);
+                setHalfCarry(flags, (a & 0x0fu) == 0x00); // If half-overflow, 4 least significant bits will be 0
+                setSubstraction(flags, false);
+                // Leave carry as-is
+                break;
+            case FLAGS_DEC:
+                setZero(flags, a == 0);
+                setHalfCarry(flags, (a & 0x0fu) == 0x0f); // If half-underflow, 4 least significant bits will turn from 0000 (0x0) to 1111 (0xf)
+                setSubstraction(flags, true);
+                // Leave carry as-is
+                break;
+            default:
+                break;
+        }
+    }
+
 }
 
 #endif //FB_CORE_UTIL_FLAGS_H
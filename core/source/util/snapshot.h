@@ -0,0 +1,80 @@
+/**
+ * Copyright 2021 Michel Kremer (kremi151)
+ *
+ * Licensed under the Apache License, Version 2.0 (the License);
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FB_CORE_UTIL_SNAPSHOT_H
+#define FB_CORE_UTIL_SNAPSHOT_H
+
+#include <util/typedefs.h>
+#include <cstring>
+#include <type_traits>
+
+namespace FunkyBoy::Snapshot {
+
+    /**
+     * Writes values in their in-memory representation to a flat buffer. In contrast to save states, snapshots can
+     * only be restored by the same build of the emulator.
+     * Without a buffer, the writer only counts the number of bytes which would be written.
+     */
+    class Writer {
+    private:
+        u8 *const buffer;
+        size_t offset;
+
+    public:
+        explicit Writer(u8 *buffer): buffer(buffer), offset(0) {
+        }
+
+        inline void writeBytes(const void *data, size_t length) {
+            if (buffer != nullptr) {
+                std::memcpy(buffer + offset, data, length);
+            }
+            offset += length;
+        }
+
+        template<typename T>
+        inline void write(const T &value) {
+            static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable values can be written");
+            writeBytes(&value, sizeof(T));
+        }
+
+        inline size_t getSize() const {
+            return offset;
+        }
+    };
+
+    class Reader {
+    private:
+        const u8 *ptr;
+
+    public:
+        explicit Reader(const u8 *buffer): ptr(buffer) {
+        }
+
+        inline void readBytes(void *data, size_t length) {
+            std::memcpy(data, ptr, length);
+            ptr += length;
+        }
+
+        template<typename T>
+        inline void read(T &value) {
+            static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable values can be read");
+            readBytes(&value, sizeof(T));
+        }
+    };
+
+}
+
+#endif //FB_CORE_UTIL_SNAPSHOT_H
@@ -31,7 +31,7 @@ DisplayController3DS::DisplayController3DS()
 {
 }
 
-void DisplayController3DS::drawScanLine(FunkyBoy::u8 y, FunkyBoy::u8 *buffer) {
+void DisplayController3DS::drawScreen(const FunkyBoy::FrameBuffer &emulatorFrameBuffer) {
     if (!frameBuffer) {
         frameBuffer = gfxGetFramebuffer(GFX_TOP, GFX_LEFT, &frameWidth, &frameHeight);
     }
@@ -40,18 +40,18 @@ void DisplayController3DS::drawScanLine(FunkyBoy::u8 y, FunkyBoy::u8 *buffer) {
         offsetEffectiveY = (frameWidth - FB_GB_DISPLAY_HEIGHT) / 2;
         offsetsCalculated = true;
     }
-    y = offsetEffectiveY + FB_GB_DISPLAY_HEIGHT - y - 1;
-    for (u8 x = 0; x < FB_GB_DISPLAY_WIDTH; x++) {
-        u8 *fbOffset = frameBuffer + ((offsetEffectiveX + x) * frameWidth * 4) + (y * 4);
-        *(fbOffset++) = 0xff;
-        *(fbOffset++) = Palette::ARGB8888::DMG[*buffer & 3u][0];
-        *(fbOffset++) = Palette::ARGB8888::DMG[*buffer & 3u][1];
-        *(fbOffset) = Palette::ARGB8888::DMG[*buffer & 3u][2];
-        buffer++;
+    auto buffer = static_cast<const u8 *>(emulatorFrameBuffer.getPixels());
+    for (u8 y = 0; y < FB_GB_DISPLAY_HEIGHT; y++) {
+        const u8 rotatedY = offsetEffectiveY + FB_GB_DISPLAY_HEIGHT - y - 1;
+        for (u8 x = 0; x < FB_GB_DISPLAY_WIDTH; x++) {
+            u8 *fbOffset = frameBuffer + ((offsetEffectiveX + x) * frameWidth * 4) + (rotatedY * 4);
+            *(fbOffset++) = 0xff;
+            *(fbOffset++) = Palette::ARGB8888::DMG[*buffer & 3u][0];
+            *(fbOffset++) = Palette::ARGB8888::DMG[*buffer & 3u][1];
+            *(fbOffset) = Palette::ARGB8888::DMG[*buffer & 3u][2];
+            buffer++;
+        }
     }
-}
-
-void DisplayController3DS::drawScreen() {
     gspWaitForVBlank();
     gfxSwapBuffers();
     frameBuffer = gfxGetFramebuffer(GFX_TOP, GFX_LEFT, &frameWidth, &frameHeight);
@@ -31,8 +31,8 @@ namespace FunkyBoy::Controller {
     public:
         DisplayController3DS();
 
-        void drawScanLine(u8 y, u8 *buffer) override;
-        void drawScreen() override;
+        // Expects the frame buffer to be in PIXEL_FORMAT_INDEXED, as the screen is rotated
+        void drawScreen(const FrameBuffer &frameBuffer) override;
     };
 
 }
@@ -116,6 +116,7 @@ extern "C" {
         FunkyBoy::Emulator emulator(FunkyBoy::GameBoyType::GameBoyDMG);
         emulator.setControllers(FunkyBoy::Controller::Controllers()
             .withDisplay(std::make_shared<FunkyBoy::Controller::DisplayController3DS>()));
+        emulator.setPixelFormat(FunkyBoy::PixelFormat::PIXEL_FORMAT_INDEXED);
 
         printf("Launching game...\n");
         auto status = emulator.loadGame(FB_3DS_ROM_PATH);
@@ -150,24 +151,23 @@ extern "C" {
         while (aptMainLoop())
         {
             // TODO: Limit frame rate
-            if (emulator.doTick() & FB_RET_NEW_FRAME) {
-                hidScanInput();
-                currentKeysDown = hidKeysDown();
-                currentKeysHeld = hidKeysHeld();
-                if (currentKeysHeld != lastKeysHeld || currentKeysDown != lastKeysDown) {
-                    FunkyBoy::u32_fast kDown = currentKeysDown | currentKeysHeld;
-                    emulator.setInputState(FunkyBoy::Controller::JOYPAD_A, kDown & KEY_A);
-                    emulator.setInputState(FunkyBoy::Controller::JOYPAD_B, kDown & KEY_B);
-                    emulator.setInputState(FunkyBoy::Controller::JOYPAD_START, kDown & KEY_START);
-                    emulator.setInputState(FunkyBoy::Controller::JOYPAD_SELECT, kDown & KEY_SELECT);
-                    emulator.setInputState(FunkyBoy::Controller::JOYPAD_UP, kDown & KEY_UP);
-                    emulator.setInputState(FunkyBoy::Controller::JOYPAD_DOWN, kDown & KEY_DOWN);
-                    emulator.setInputState(FunkyBoy::Controller::JOYPAD_LEFT, kDown & KEY_LEFT);
-                    emulator.setInputState(FunkyBoy::Controller::JOYPAD_RIGHT, kDown & KEY_RIGHT);
-                }
-                lastKeysDown = currentKeysDown;
-                lastKeysHeld = currentKeysHeld;
+            emulator.runFrame();
+            hidScanInput();
+            currentKeysDown = hidKeysDown();
+            currentKeysHeld = hidKeysHeld();
+            if (currentKeysHeld != lastKeysHeld || currentKeysDown != lastKeysDown) {
+                FunkyBoy::u32_fast kDown = currentKeysDown | currentKeysHeld;
+                emulator.setInputState(FunkyBoy::Controller::JOYPAD_A, kDown & KEY_A);
+                emulator.setInputState(FunkyBoy::Controller::JOYPAD_B, kDown & KEY_B);
+                emulator.setInputState(FunkyBoy::Controller::JOYPAD_START, kDown & KEY_START);
+                emulator.setInputState(FunkyBoy::Controller::JOYPAD_SELECT, kDown & KEY_SELECT);
+                emulator.setInputState(FunkyBoy::Controller::JOYPAD_UP, kDown & KEY_UP);
+                emulator.setInputState(FunkyBoy::Controller::JOYPAD_DOWN, kDown & KEY_DOWN);
+                emulator.setInputState(FunkyBoy::Controller::JOYPAD_LEFT, kDown & KEY_LEFT);
+                emulator.setInputState(FunkyBoy::Controller::JOYPAD_RIGHT, kDown & KEY_RIGHT);
             }
+            lastKeysDown = currentKeysDown;
+            lastKeysHeld = currentKeysHeld;
 
             // Your code goes here
             if (currentKeysDown & KEY_X) {
@@ -0,0 +1,171 @@
+/**
+ * Copyright 2021 Michel Kremer (kremi151)
+ *
+ * Licensed under the Apache License, Version 2.0 (the License);
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "batch_runner.h"
+
+#include <batch/input_script.h>
+#include <controllers/serial_batch.h>
+#include <controllers/display_batch.h>
+#include <emulator/emulator.h>
+#include <exception/read_exception.h>
+#include <palette/dmg_palette.h>
+#include <chrono>
+#include <fstream>
+#include <stdexcept>
+
+#define FB_FNV_OFFSET_BASIS 0xcbf29ce484222325ull
+#define FB_FNV_PRIME 0x100000001b3ull
+
+// Machine cycles of a frame while the LCD is on
+#define FB_FRAME_CYCLES 17556
+
+using namespace FunkyBoy;
+using namespace FunkyBoy::Batch;
+
+struct BatchRunner::Worker {
+    std::shared_ptr<Controller::SerialControllerBatch> serial = std::make_shared<Controller::SerialControllerBatch>();
+    std::shared_ptr<Controller::DisplayControllerBatch> display = std::make_shared<Controller::DisplayControllerBatch>();
+};
+
+namespace FunkyBoy::Batch {
+
+    inline u64 hashFrame(const u8 *frame) {
+        u64 hash = FB_FNV_OFFSET_BASIS;
+        for (size_t i = 0 ; i < FB_GB_DISPLAY_WIDTH * FB_GB_DISPLAY_HEIGHT ; i++) {
+            hash = (hash ^ frame[i]) * FB_FNV_PRIME;
+        }
+        return hash;
+    }
+
+    // Writes the frame as a binary portable graymap
+    inline void writeFrame(const fs::path &path, const u8 *frame) {
+        std::ofstream stream(path, std::ios::binary | std::ios::out);
+        if (!stream) {
+            throw std::runtime_error("Cannot write frame to " + path.string());
+        }
+        stream << "P5\n" << FB_GB_DISPLAY_WIDTH << " " << FB_GB_DISPLAY_HEIGHT << "\n255\n";
+        for (size_t i = 0 ; i < FB_GB_DISPLAY_WIDTH * FB_GB_DISPLAY_HEIGHT ; i++) {
+            stream.put(static_cast<char>(Palette::ARGB8888::DMG[frame[i] & 0b11u][0]));
+        }
+    }
+
+}
+
+BatchRunner::BatchRunner(size_t threadCount)
+    : pool(threadCount)
+    , emulatorPool(GameBoyType::GameBoyDMG)
+    , lastFrameOnly(false)
+{
+    for (size_t i = 0 ; i < pool.getWorkerCount() ; i++) {
+        workers.push_back(std::make_unique<Worker>());
+    }
+}
+
+BatchRunner::~BatchRunner() = default;
+
+ROMImagePtr BatchRunner::getROMImage(const fs::path &path) {
+    std::lock_guard<std::mutex> lock(romImagesMutex);
+    auto it = romImages.find(path);
+    if (it != romImages.end()) {
+        return it->second;
+    }
+    ROMImagePtr image = ROMImage::fromFile(path);
+    romImages[path] = image;
+    return image;
+}
+
+void BatchRunner::runJob(const Job &job, Worker &worker, JobResult &result) {
+    InputScript inputScript;
+    if (!job.inputScriptPath.empty()) {
+        std::ifstream stream(job.inputScriptPath);
+        if (!stream) {
+            throw Exception::ReadException("Cannot read input script " + job.inputScriptPath.string());
+        }
+        inputScript = InputScript::parse(stream);
+    }
+
+    // Emulators of failed jobs are not returned to the pool
+    std::unique_ptr<Emulator> emulatorPtr = emulatorPool.acquire(getROMImage(job.romPath));
+    Emulator &emulator = *emulatorPtr;
+    if (emulator.getCartridgeStatus() != CartridgeStatus::Loaded) {
+        throw std::runtime_error("ROM could not be loaded: " + getCartridgeStatusDescription(emulator.getCartridgeStatus()));
+    }
+    emulator.setControllers(Controller::Controllers()
+            .withSerial(worker.serial)
+            .withDisplay(worker.display));
+    worker.serial->clear();
+    worker.display->clear();
+    emulator.setPixelFormat(PixelFormat::PIXEL_FORMAT_INDEXED);
+    emulator.setRenderPolicy(lastFrameOnly ? RenderPolicy::RENDER_ON_REQUEST : RenderPolicy::RENDER_ALWAYS);
+
+    u8 pressedButtons = 0;
+    for (result.frames = 0 ; result.frames < job.frames ; result.frames++) {
+        u8 buttons = inputScript.getButtons(result.frames);
+        for (u8 key = 0 ; key < 8 ; key++) {
+            if (((buttons ^ pressedButtons) >> key) & 1u) {
+                emulator.setInputState(static_cast<Controller::JoypadKey>(key), (buttons >> key) & 1u);
+            }
+        }
+        pressedButtons = buttons;
+
+        if (result.frames + 1 == job.frames) {
+            emulator.requestFrame();
+        }
+        // Without the LCD, no new frame is ever reported, so a frame ends after the time it would take otherwise
+        StopReason stopReason = emulator.runUntil(STOP_NEW_FRAME, FB_FRAME_CYCLES);
+        if (stopReason != STOP_NEW_FRAME && stopReason != STOP_CYCLE_BUDGET) {
+            throw std::runtime_error("Emulation failed in frame " + std::to_string(result.frames));
+        }
+    }
+
+    result.frameHash = hashFrame(worker.display->getFrame());
+    result.serialOutput = worker.serial->getOutput();
+
+    if (!job.serialOutputPath.empty()) {
+        std::ofstream stream(job.serialOutputPath, std::ios::binary | std::ios::out);
+        stream << result.serialOutput;
+    }
+    if (!job.frameOutputPath.empty()) {
+        writeFrame(job.frameOutputPath, worker.display->getFrame());
+    }
+    if (!job.cartridgeRamOutputPath.empty() && emulator.getCartridgeRamSize() > 0) {
+        std::ofstream stream(job.cartridgeRamOutputPath, std::ios::binary | std::ios::out);
+        emulator.writeCartridgeRam(stream);
+    }
+
+    emulatorPool.release(std::move(emulatorPtr));
+}
+
+void BatchRunner::run(const std::vector<Job> &jobs, const JobResultCallback &callback) {
+    std::mutex callbackMutex;
+    pool.run(jobs.size(), [&](size_t index, size_t workerIndex) {
+        JobResult result{};
+        result.index = index;
+        auto start = std::chrono::steady_clock::now();
+        try {
+            runJob(jobs[index], *workers[workerIndex], result);
+            result.success = true;
+        } catch (const std::exception &exception) {
+            result.error = exception.what();
+        } catch (...) {
+            result.error = "Unknown error";
+        }
+        result.milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        std::lock_guard<std::mutex> lock(callbackMutex);
+        callback(result);
+    });
+}
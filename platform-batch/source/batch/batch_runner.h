@@ -0,0 +1,79 @@
+/**
+ * Copyright 2021 Michel Kremer (kremi151)
+ *
+ * Licensed under the Apache License, Version 2.0 (the License);
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FB_BATCH_BATCH_RUNNER_H
+#define FB_BATCH_BATCH_RUNNER_H
+
+#include <batch/job.h>
+#include <batch/work_stealing_pool.h>
+#include <batch/emulator_pool.h>
+#include <cartridge/rom_image.h>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace FunkyBoy::Batch {
+
+    typedef std::function<void(const JobResult &result)> JobResultCallback;
+
+    /**
+     * Runs jobs headlessly on a work-stealing pool. Each ROM is only read once and its image is shared by all workers.
+     * Emulators are checked out of a pool and reset between jobs instead of being constructed again.
+     */
+    class BatchRunner {
+    private:
+        struct Worker;
+
+        WorkStealingPool pool;
+        std::vector<std::unique_ptr<Worker>> workers;
+        EmulatorPool emulatorPool;
+
+        std::mutex romImagesMutex;
+        std::map<fs::path, ROMImagePtr> romImages;
+
+        bool lastFrameOnly;
+
+        ROMImagePtr getROMImage(const fs::path &path);
+        void runJob(const Job &job, Worker &worker, JobResult &result);
+
+    public:
+        // Uses one thread per hardware thread if the given count is 0
+        explicit BatchRunner(size_t threadCount);
+        ~BatchRunner();
+
+        BatchRunner(const BatchRunner &other) = delete;
+        BatchRunner &operator= (const BatchRunner &other) = delete;
+
+        inline size_t getThreadCount() const {
+            return pool.getWorkerCount();
+        }
+
+        // Only draws the last frame of each job, which is the only one that is looked at. Lines which are not drawn in
+        // the last frame, e.g. because the LCD is switched off, are blank instead of being kept from earlier frames.
+        inline void setLastFrameOnly(bool lastFrameOnly) {
+            this->lastFrameOnly = lastFrameOnly;
+        }
+
+        // Runs all jobs and returns once they have finished. The callback is invoked as soon as a job has finished,
+        // but never concurrently.
+        void run(const std::vector<Job> &jobs, const JobResultCallback &callback);
+    };
+
+}
+
+#endif //FB_BATCH_BATCH_RUNNER_H
@@ -0,0 +1,94 @@
+/**
+ * Copyright 2021 Michel Kremer (kremi151)
+ *
+ * Licensed under the Apache License, Version 2.0 (the License);
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "emulator_pool.h"
+
+#include <algorithm>
+
+using namespace FunkyBoy;
+using namespace FunkyBoy::Batch;
+
+namespace FunkyBoy::Batch {
+
+    inline bool hasLoaded(Emulator &emulator, const ROMImagePtr &romImage) {
+        return emulator.getROMImage() == romImage && emulator.getCartridgeStatus() == CartridgeStatus::Loaded;
+    }
+
+}
+
+EmulatorPool::EmulatorPool(GameBoyType gbType)
+    : gbType(gbType)
+{
+}
+
+void EmulatorPool::prewarm(const ROMImagePtr &romImage, size_t count) {
+    size_t loaded;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        loaded = std::count_if(idleEmulators.begin(), idleEmulators.end(), [&](const std::unique_ptr<Emulator> &emulator) {
+            return hasLoaded(*emulator, romImage);
+        });
+    }
+    // Emulators are constructed outside of the lock, so that other threads can go on acquiring in the meantime
+    for (; loaded < count ; loaded++) {
+        auto emulator = std::make_unique<Emulator>(gbType);
+        if (emulator->loadGame(romImage) != CartridgeStatus::Loaded) {
+            return;
+        }
+        release(std::move(emulator));
+    }
+}
+
+std::unique_ptr<Emulator> EmulatorPool::acquire(const ROMImagePtr &romImage) {
+    std::unique_ptr<Emulator> emulator;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!idleEmulators.empty()) {
+            auto it = std::find_if(idleEmulators.rbegin(), idleEmulators.rend(), [&](const std::unique_ptr<Emulator> &emulator) {
+                return hasLoaded(*emulator, romImage);
+            });
+            if (it == idleEmulators.rend()) {
+                it = idleEmulators.rbegin();
+            }
+            emulator = std::move(*it);
+            idleEmulators.erase(std::next(it).base());
+        }
+    }
+
+    if (emulator == nullptr) {
+        emulator = std::make_unique<Emulator>(gbType);
+        emulator->loadGame(romImage);
+        return emulator;
+    }
+    if (!hasLoaded(*emulator, romImage)) {
+        emulator->loadGame(romImage);
+    }
+    emulator->reset(false);
+    return emulator;
+}
+
+void EmulatorPool::release(std::unique_ptr<Emulator> emulator) {
+    if (emulator == nullptr) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    idleEmulators.push_back(std::move(emulator));
+}
+
+size_t EmulatorPool::getIdleCount() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return idleEmulators.size();
+}
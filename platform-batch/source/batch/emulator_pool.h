@@ -0,0 +1,59 @@
+/**
+ * Copyright 2021 Michel Kremer (kremi151)
+ *
+ * Licensed under the Apache License, Version 2.0 (the License);
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FB_BATCH_EMULATOR_POOL_H
+#define FB_BATCH_EMULATOR_POOL_H
+
+#include <emulator/emulator.h>
+#include <emulator/gb_type.h>
+#include <cartridge/rom_image.h>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace FunkyBoy::Batch {
+
+    /**
+     * Keeps idle emulators around, so that they can be reset instead of being constructed again. Emulators keep the
+     * controllers which have been set by their last user.
+     */
+    class EmulatorPool {
+    private:
+        const GameBoyType gbType;
+
+        std::mutex mutex;
+        std::vector<std::unique_ptr<Emulator>> idleEmulators;
+
+    public:
+        explicit EmulatorPool(GameBoyType gbType);
+
+        EmulatorPool(const EmulatorPool &other) = delete;
+        EmulatorPool &operator= (const EmulatorPool &other) = delete;
+
+        // Creates idle emulators until the given number of them has loaded the image
+        void prewarm(const ROMImagePtr &romImage, size_t count);
+
+        // Returns an emulator at its power-up state with the given image loaded. Emulators which have already loaded
+        // the same image are preferred. The caller has to check the cartridge status, as the image might be invalid.
+        std::unique_ptr<Emulator> acquire(const ROMImagePtr &romImage);
+        void release(std::unique_ptr<Emulator> emulator);
+
+        size_t getIdleCount();
+    };
+
+}
+
+#endif //FB_BATCH_EMULATOR_POOL_H
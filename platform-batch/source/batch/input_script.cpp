@@ -0,0 +1,103 @@
+/**
+ * Copyright 2021 Michel Kremer (kremi151)
+ *
+ * Licensed under the Apache License, Version 2.0 (the License);
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "input_script.h"
+
+#include <controllers/joypad.h>
+#include <exception/read_exception.h>
+#include <algorithm>
+#include <limits>
+#include <sstream>
+#include <string>
+
+using namespace FunkyBoy;
+using namespace FunkyBoy::Batch;
+
+namespace FunkyBoy::Batch {
+
+    inline u8 parseButton(const std::string &name) {
+        if (name == "A") {
+            return 1u << Controller::JoypadKey::JOYPAD_A;
+        } else if (name == "B") {
+            return 1u << Controller::JoypadKey::JOYPAD_B;
+        } else if (name == "SELECT") {
+            return 1u << Controller::JoypadKey::JOYPAD_SELECT;
+        } else if (name == "START") {
+            return 1u << Controller::JoypadKey::JOYPAD_START;
+        } else if (name == "RIGHT") {
+            return 1u << Controller::JoypadKey::JOYPAD_RIGHT;
+        } else if (name == "LEFT") {
+            return 1u << Controller::JoypadKey::JOYPAD_LEFT;
+        } else if (name == "UP") {
+            return 1u << Controller::JoypadKey::JOYPAD_UP;
+        } else if (name == "DOWN") {
+            return 1u << Controller::JoypadKey::JOYPAD_DOWN;
+        }
+        throw Exception::ReadException("Unknown button: " + name);
+    }
+
+}
+
+InputScript InputScript::parse(std::istream &stream) {
+    InputScript script;
+    std::string line;
+    while (std::getline(stream, line)) {
+        std::istringstream lineStream(line);
+        std::string frame, buttons;
+        if (!(lineStream >> frame) || frame[0] == '#') {
+            continue;
+        }
+        if (!(lineStream >> buttons)) {
+            throw Exception::ReadException("Missing buttons for frame " + frame);
+        }
+        Entry entry{};
+        // Read as a signed number, as negative numbers would otherwise silently wrap around
+        long long frameNumber;
+        try {
+            frameNumber = std::stoll(frame);
+        } catch (const std::exception &) {
+            throw Exception::ReadException("Invalid frame number: " + frame);
+        }
+        if (frameNumber < 0 || frameNumber > std::numeric_limits<u32>::max()) {
+            throw Exception::ReadException("Invalid frame number: " + frame);
+        }
+        entry.frame = static_cast<u32>(frameNumber);
+        if (!script.entries.empty() && entry.frame < script.entries.back().frame) {
+            throw Exception::ReadException("Frames are not in ascending order: " + frame);
+        }
+        if (buttons != "-") {
+            size_t start = 0;
+            size_t end;
+            do {
+                end = buttons.find('+', start);
+                entry.buttons |= parseButton(buttons.substr(start, end - start));
+                start = end + 1;
+            } while (end != std::string::npos);
+        }
+        script.entries.push_back(entry);
+    }
+    return script;
+}
+
+u8 InputScript::getButtons(u32 frame) const {
+    auto next = std::upper_bound(entries.begin(), entries.end(), frame, [](u32 frame, const Entry &entry) {
+        return frame < entry.frame;
+    });
+    if (next == entries.begin()) {
+        return 0;
+    }
+    return (next - 1)->buttons;
+}
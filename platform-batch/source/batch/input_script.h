@@ -0,0 +1,51 @@
+/**
+ * Copyright 2021 Michel Kremer (kremi151)
+ *
+ * Licensed under the Apache License, Version 2.0 (the License);
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FB_BATCH_INPUT_SCRIPT_H
+#define FB_BATCH_INPUT_SCRIPT_H
+
+#include <util/typedefs.h>
+#include <istream>
+#include <vector>
+
+namespace FunkyBoy::Batch {
+
+    /**
+     * Buttons to be pressed during a run. Each line of a script consists of a frame number and the buttons which are
+     * pressed from this frame on, separated by +, or - for none. Buttons are named A, B, SELECT, START, RIGHT, LEFT,
+     * UP and DOWN. Frames have to be in ascending order.
+     */
+    class InputScript {
+    private:
+        struct Entry {
+            u32 frame;
+            // Bitmap of the pressed buttons, indexed by Controller::JoypadKey
+            u8 buttons;
+        };
+
+        std::vector<Entry> entries;
+
+    public:
+        // Throws a ReadException if the script cannot be parsed
+        static InputScript parse(std::istream &stream);
+
+        // Returns the bitmap of the buttons which are pressed during the given frame
+        u8 getButtons(u32 frame) const;
+    };
+
+}
+
+#endif //FB_BATCH_INPUT_SCRIPT_H
@@ -0,0 +1,71 @@
+/**
+ * Copyright 2021 Michel Kremer (kremi151)
+ *
+ * Licensed under the Apache License, Version 2.0 (the License);
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "job.h"
+
+#include <exception/read_exception.h>
+#include <limits>
+#include <sstream>
+
+using namespace FunkyBoy;
+
+std::vector<Batch::Job> Batch::parseJobs(std::istream &stream, const fs::path &baseDirectory) {
+    std::vector<Job> jobs;
+    std::string line;
+    size_t lineNumber = 0;
+    while (std::getline(stream, line)) {
+        lineNumber++;
+        std::istringstream lineStream(line);
+        std::string romPath;
+        if (!(lineStream >> romPath) || romPath[0] == '#') {
+            continue;
+        }
+        Job job{};
+        job.romPath = baseDirectory / romPath;
+        // Read as a signed number, as negative numbers would otherwise silently wrap around
+        i64 frames;
+        if (!(lineStream >> frames)) {
+            throw Exception::ReadException("Missing number of frames in line " + std::to_string(lineNumber));
+        }
+        if (frames <= 0 || frames > std::numeric_limits<u32>::max()) {
+            throw Exception::ReadException("Invalid number of frames in line " + std::to_string(lineNumber) + ": "
+                                           + std::to_string(frames));
+        }
+        job.frames = static_cast<u32>(frames);
+        std::string option;
+        while (lineStream >> option) {
+            size_t separator = option.find('=');
+            if (separator == std::string::npos) {
+                throw Exception::ReadException("Expected key=value in line " + std::to_string(lineNumber) + ": " + option);
+            }
+            std::string key = option.substr(0, separator);
+            fs::path path = baseDirectory / option.substr(separator + 1);
+            if (key == "input") {
+                job.inputScriptPath = path;
+            } else if (key == "serial") {
+                job.serialOutputPath = path;
+            } else if (key == "frame") {
+                job.frameOutputPath = path;
+            } else if (key == "ram") {
+                job.cartridgeRamOutputPath = path;
+            } else {
+                throw Exception::ReadException("Unknown option in line " + std::to_string(lineNumber) + ": " + key);
+            }
+        }
+        jobs.push_back(std::move(job));
+    }
+    return jobs;
+}
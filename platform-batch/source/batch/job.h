@@ -0,0 +1,61 @@
+/**
+ * Copyright 2021 Michel Kremer (kremi151)
+ *
+ * Licensed under the Apache License, Version 2.0 (the License);
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FB_BATCH_JOB_H
+#define FB_BATCH_JOB_H
+
+#include <util/typedefs.h>
+#include <util/fs.h>
+#include <istream>
+#include <string>
+#include <vector>
+
+namespace FunkyBoy::Batch {
+
+    struct Job {
+        fs::path romPath;
+        // No buttons are pressed if no input script is set
+        fs::path inputScriptPath;
+        u32 frames;
+
+        // Outputs are only written if their path is set
+        fs::path serialOutputPath;
+        fs::path frameOutputPath;
+        fs::path cartridgeRamOutputPath;
+    };
+
+    struct JobResult {
+        // Index of the job in the list which has been passed to the runner
+        size_t index;
+        bool success;
+        std::string error;
+        u32 frames;
+        double milliseconds;
+        // FNV-1a hash of the shades of the last frame
+        u64 frameHash;
+        std::string serialOutput;
+    };
+
+    /**
+     * Parses a list of jobs, one per line. Each line consists of the path to the ROM and the number of frames to run,
+     * followed by optional key=value pairs: input, serial, frame and ram. Empty lines and lines starting with # are
+     * skipped. Relative paths are resolved against the given directory.
+     */
+    std::vector<Job> parseJobs(std::istream &stream, const fs::path &baseDirectory);
+
+}
+
+#endif //FB_BATCH_JOB_H
@@ -0,0 +1,96 @@
+/**
+ * Copyright 2021 Michel Kremer (kremi151)
+ *
+ * Licensed under the Apache License, Version 2.0 (the License);
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "work_stealing_pool.h"
+
+#include <algorithm>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace FunkyBoy::Batch;
+
+namespace FunkyBoy::Batch {
+
+    struct TaskQueue {
+        std::mutex mutex;
+        std::deque<size_t> tasks;
+    };
+
+    // Takes the next task of the worker's own queue, or steals the last one of another queue
+    inline bool takeTask(std::vector<std::unique_ptr<TaskQueue>> &queues, size_t worker, size_t &task) {
+        {
+            TaskQueue &queue = *queues[worker];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (!queue.tasks.empty()) {
+                task = queue.tasks.front();
+                queue.tasks.pop_front();
+                return true;
+            }
+        }
+        // No tasks are added while running, so all tasks have been taken once every queue is empty
+        for (size_t i = 1 ; i < queues.size() ; i++) {
+            TaskQueue &queue = *queues[(worker + i) % queues.size()];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (!queue.tasks.empty()) {
+                task = queue.tasks.back();
+                queue.tasks.pop_back();
+                return true;
+            }
+        }
+        return false;
+    }
+
+}
+
+WorkStealingPool::WorkStealingPool(size_t workerCount)
+    : workerCount(workerCount > 0 ? workerCount : std::max(std::thread::hardware_concurrency(), 1u))
+{
+}
+
+void WorkStealingPool::run(size_t taskCount, const std::function<void(size_t task, size_t worker)> &function) {
+    size_t activeWorkers = std::min(workerCount, taskCount);
+    if (activeWorkers == 0) {
+        return;
+    }
+
+    std::vector<std::unique_ptr<TaskQueue>> queues;
+    for (size_t worker = 0 ; worker < activeWorkers ; worker++) {
+        queues.push_back(std::make_unique<TaskQueue>());
+    }
+    for (size_t task = 0 ; task < taskCount ; task++) {
+        queues[task * activeWorkers / taskCount]->tasks.push_back(task);
+    }
+
+    auto work = [&](size_t worker) {
+        size_t task;
+        while (takeTask(queues, worker, task)) {
+            function(task, worker);
+        }
+    };
+
+    // The calling thread acts as the first worker
+    std::vector<std::thread> threads;
+    for (size_t worker = 1 ; worker < activeWorkers ; worker++) {
+        threads.emplace_back(work, worker);
+    }
+    work(0);
+    for (auto &thread : threads) {
+        thread.join();
+    }
+}
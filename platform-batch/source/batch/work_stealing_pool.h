@@ -0,0 +1,49 @@
+/**
+ * Copyright 2021 Michel Kremer (kremi151)
+ *
+ * Licensed under the Apache License, Version 2.0 (the License);
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FB_BATCH_WORK_STEALING_POOL_H
+#define FB_BATCH_WORK_STEALING_POOL_H
+
+#include <functional>
+#include <cstddef>
+
+namespace FunkyBoy::Batch {
+
+    /**
+     * Runs tasks on a fixed number of threads. Every worker starts with its own queue holding a contiguous range of
+     * the tasks, so that similar tasks which are next to each other tend to run on the same worker. Workers which have
+     * run out of tasks steal from the back of the queues of the other ones.
+     */
+    class WorkStealingPool {
+    private:
+        const size_t workerCount;
+
+    public:
+        // Uses one worker per hardware thread if the given count is 0
+        explicit WorkStealingPool(size_t workerCount);
+
+        inline size_t getWorkerCount() const {
+            return workerCount;
+        }
+
+        // Runs the tasks with the indexes from 0 to taskCount - 1 and returns once all of them have finished. The
+        // function receives the index of the task and the index of the worker running it, and must not throw.
+        void run(size_t taskCount, const std::function<void(size_t task, size_t worker)> &function);
+    };
+
+}
+
+#endif //FB_BATCH_WORK_STEALING_POOL_H
@@ -0,0 +1,42 @@
+/**
+ * Copyright 2021 Michel Kremer (kremi151)
+ *
+ * Licensed under the Apache License, Version 2.0 (the License);
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FB_BATCH_DISPLAY_BATCH_H
+#define FB_BATCH_DISPLAY_BATCH_H
+
+#include <controllers/display.h>
+
+namespace FunkyBoy::Controller {
+
+    // Keeps the shades of the last completed frame
+    class DisplayControllerBatch: public DisplayController {
+    private:
+        u8 frame[FB_GB_DISPLAY_WIDTH * FB_GB_DISPLAY_HEIGHT]{};
+
+    public:
+        // Expects the frame buffer to be in PIXEL_FORMAT_INDEXED
+        void drawScreen(const FrameBuffer &frameBuffer) override;
+
+        inline const u8 *getFrame() const {
+            return frame;
+        }
+
+        void clear();
+    };
+
+}
+
+#endif //FB_BATCH_DISPLAY_BATCH_H
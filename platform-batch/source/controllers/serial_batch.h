@@ -0,0 +1,43 @@
+/**
+ * Copyright 2021 Michel Kremer (kremi151)
+ *
+ * Licensed under the Apache License, Version 2.0 (the License);
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FB_BATCH_SERIAL_BATCH_H
+#define FB_BATCH_SERIAL_BATCH_H
+
+#include <controllers/serial.h>
+#include <string>
+
+namespace FunkyBoy::Controller {
+
+    class SerialControllerBatch: public SerialController {
+    private:
+        std::string output;
+
+    public:
+        void sendByte(u8 data) override;
+
+        inline const std::string &getOutput() const {
+            return output;
+        }
+
+        inline void clear() {
+            output.clear();
+        }
+    };
+
+}
+
+#endif //FB_BATCH_SERIAL_BATCH_H
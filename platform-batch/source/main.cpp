@@ -0,0 +1,110 @@
+/**
+ * Copyright 2021 Michel Kremer (kremi151)
+ *
+ * Licensed under the Apache License, Version 2.0 (the License);
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <batch/batch_runner.h>
+#include <batch/job.h>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+using namespace FunkyBoy;
+
+namespace {
+
+    void printUsage(const char *executable) {
+        std::cerr << "Usage: " << executable << " [--threads <count>] [--last-frame-only] <job file>" << std::endl;
+    }
+
+}
+
+int main(int argc, char **argv) {
+    size_t threadCount = 0;
+    bool lastFrameOnly = false;
+    const char *jobFilePath = nullptr;
+
+    for (int i = 1 ; i < argc ; i++) {
+        if ((std::strcmp(argv[i], "-t") == 0 || std::strcmp(argv[i], "--threads") == 0) && i + 1 < argc) {
+            try {
+                threadCount = std::stoul(argv[++i]);
+            } catch (const std::exception &) {
+                printUsage(argv[0]);
+                return 1;
+            }
+        } else if (std::strcmp(argv[i], "--last-frame-only") == 0) {
+            lastFrameOnly = true;
+        } else if (std::strcmp(argv[i], "-h") == 0 || std::strcmp(argv[i], "--help") == 0) {
+            printUsage(argv[0]);
+            return 0;
+        } else if (jobFilePath == nullptr) {
+            jobFilePath = argv[i];
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+    if (jobFilePath == nullptr) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    std::vector<Batch::Job> jobs;
+    try {
+        std::ifstream jobFile(jobFilePath);
+        if (!jobFile) {
+            std::cerr << "Cannot read job file " << jobFilePath << std::endl;
+            return 1;
+        }
+        jobs = Batch::parseJobs(jobFile, fs::absolute(jobFilePath).parent_path());
+    } catch (const std::exception &exception) {
+        std::cerr << exception.what() << std::endl;
+        return 1;
+    }
+
+    Batch::BatchRunner runner(threadCount);
+    runner.setLastFrameOnly(lastFrameOnly);
+    size_t failed = 0;
+    double totalMilliseconds = 0;
+    u64 totalFrames = 0;
+    auto start = std::chrono::steady_clock::now();
+
+    runner.run(jobs, [&](const Batch::JobResult &result) {
+        if (!result.success) {
+            failed++;
+        }
+        totalMilliseconds += result.milliseconds;
+        totalFrames += result.frames;
+        std::cout << result.index
+                  << '\t' << (result.success ? "OK" : "FAILED")
+                  << '\t' << result.frames
+                  << '\t' << std::fixed << std::setprecision(1) << result.milliseconds
+                  << '\t' << std::hex << std::setw(16) << std::setfill('0') << result.frameHash << std::dec
+                  << '\t' << jobs[result.index].romPath.string();
+        if (!result.success) {
+            std::cout << '\t' << result.error;
+        }
+        std::cout << std::endl;
+    });
+
+    double wallMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    std::cerr << jobs.size() << " jobs, " << failed << " failed, " << totalFrames << " frames in "
+              << std::fixed << std::setprecision(1) << wallMilliseconds << " ms on " << runner.getThreadCount()
+              << " threads (" << totalMilliseconds << " ms of emulation)" << std::endl;
+
+    return failed > 0 ? 1 : 0;
+}
@@ -22,13 +22,14 @@ using namespace FunkyBoy::Controller;
 
 AudioControllerLibretro::AudioControllerLibretro()
     : audio_cb(nullptr)
+    , enabled(true)
 {
 }
 
 AudioControllerLibretro::~AudioControllerLibretro() = default;
 
 void AudioControllerLibretro::pushSample(float left, float right) {
-    if (audio_cb != nullptr) {
+    if (enabled && audio_cb != nullptr) {
         audio_cb(left * FB_MAX_AMPLITUDE, right * FB_MAX_AMPLITUDE);
     }
 }
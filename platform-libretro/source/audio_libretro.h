@@ -25,6 +25,7 @@ namespace FunkyBoy::Controller {
     class AudioControllerLibretro: public AudioController {
     private:
         retro_audio_sample_t audio_cb;
+        bool enabled;
     public:
         explicit AudioControllerLibretro();
         ~AudioControllerLibretro() override;
@@ -32,6 +33,10 @@ namespace FunkyBoy::Controller {
         void pushSample(float left, float right) override;
 
         void setAudioCallback(retro_audio_sample_t audio_cb);
+
+        inline void setEnabled(bool enable) {
+            enabled = enable;
+        }
     };
 
 }
@@ -16,32 +16,24 @@
 
 #include "display_libretro.h"
 
-#include <palette/dmg_palette.h>
-
 using namespace FunkyBoy::Controller;
 
 DisplayControllerLibretro::DisplayControllerLibretro()
-    : pixels(new uint32_t[FB_GB_DISPLAY_WIDTH * FB_GB_DISPLAY_HEIGHT]{})
-    , videoCb(nullptr)
+    : videoCb(nullptr)
 {
 }
 
-DisplayControllerLibretro::~DisplayControllerLibretro() {
-    delete[] pixels;
-}
-
-void DisplayControllerLibretro::drawScanLine(FunkyBoy::u8 y, FunkyBoy::u8 *buffer) {
-    uint32_t pixel;
-    for (u8 x = 0 ; x < FB_GB_DISPLAY_WIDTH ; x++) {
-        auto &color = Palette::ARGB8888::DMG[*(buffer + x)];
-        pixel = (255u << 24u) | (color[0] << 16) | (color[1] << 8) | color[2];
-        pixels[(y * FB_GB_DISPLAY_WIDTH) + x] = pixel;
+void DisplayControllerLibretro::drawScreen(const FunkyBoy::FrameBuffer &frameBuffer) {
+    // XRGB8888 as requested from the frontend, which matches the default format of the emulator
+    if (videoCb != nullptr) {
+        videoCb(frameBuffer.getPixels(), FB_GB_DISPLAY_WIDTH, FB_GB_DISPLAY_HEIGHT, frameBuffer.getPitch());
     }
 }
 
-void DisplayControllerLibretro::drawScreen() {
+void DisplayControllerLibretro::keepFrame() {
     if (videoCb != nullptr) {
-        videoCb(pixels, FB_GB_DISPLAY_WIDTH, FB_GB_DISPLAY_HEIGHT, FB_GB_DISPLAY_WIDTH * sizeof(uint32_t));
+        // Passing no pixels tells the frontend to keep the previous frame
+        videoCb(nullptr, FB_GB_DISPLAY_WIDTH, FB_GB_DISPLAY_HEIGHT, 0);
     }
 }
 
@@ -25,14 +25,14 @@ namespace FunkyBoy::Controller {
 
     class DisplayControllerLibretro: public DisplayController {
     private:
-        uint32_t *pixels;
         retro_video_refresh_t videoCb;
     public:
         DisplayControllerLibretro();
-        ~DisplayControllerLibretro() override;
 
-        void drawScanLine(u8 y, u8 *buffer) override;
-        void drawScreen() override;
+        void drawScreen(const FrameBuffer &frameBuffer) override;
+
+        // Tells the frontend to keep showing the previous frame, for frames which are not drawn
+        void keepFrame();
 
         void setVideoCallback(retro_video_refresh_t cb);
     };
@@ -21,9 +21,11 @@
 #include <util/frame_executor.h>
 #include <util/membuf.h>
 
+#include <algorithm>
 #include <cstdarg>
 #include <cstring>
 #include <fstream>
+#include <sstream>
 #include <exception>
 
 #include "display_libretro.h"
@@ -53,11 +55,17 @@ extern "C" {
     static retro_log_printf_t log_cb;
 
     static std::unique_ptr<Emulator> emulator;
-    static std::shared_ptr<Controller::DisplayController> displayController;
-    static std::shared_ptr<Controller::AudioController> audioController;
+    static std::shared_ptr<Controller::DisplayControllerLibretro> displayController;
+    static std::shared_ptr<Controller::AudioControllerLibretro> audioController;
 
     static FunkyBoy::Util::FrameExecutor executeFrame(nullptr, 1.0);
 
+    // Size of a save state of the loaded game, which does not change as long as the same game is loaded
+    static size_t saveStateSize = 0;
+    // Size reported to the frontend, which has to fit both save states and snapshots of the loaded game, as the
+    // frontend allocates its buffers once regardless of the savestate context. The shorter format is padded.
+    static size_t serializeSize = 0;
+
     static unsigned currentControllerDevice;
     static unsigned currentControllerPort;
 
@@ -71,6 +79,7 @@ extern "C" {
     static bool btnRightWasPressed = false;
 
     void update_inputs();
+    void run_frame();
 
     void retro_init(void) {
         currentControllerDevice = RETRO_DEVICE_JOYPAD;
@@ -79,21 +88,15 @@ extern "C" {
         displayController = std::make_shared<Controller::DisplayControllerLibretro>();
         audioController = std::make_shared<Controller::AudioControllerLibretro>();
 
-        dynamic_cast<Controller::DisplayControllerLibretro&>(*displayController).setVideoCallback(video_cb);
-        dynamic_cast<Controller::AudioControllerLibretro&>(*audioController).setAudioCallback(audio_cb);
+        displayController->setVideoCallback(video_cb);
+        audioController->setAudioCallback(audio_cb);
 
         emulator = std::make_unique<Emulator>(GameBoyType::GameBoyDMG);
         emulator->setControllers(Controller::Controllers()
                 .withAudio(audioController)
                 .withDisplay(displayController));
 
-        executeFrame = FunkyBoy::Util::FrameExecutor([&]() {
-            ret_code result;
-            do {
-                result = emulator->doTick();
-            } while (!(result & FB_RET_NEW_FRAME));
-            update_inputs();
-        }, FB_TARGET_FPS);
+        executeFrame = FunkyBoy::Util::FrameExecutor(run_frame, FB_TARGET_FPS);
     }
 
     void retro_deinit(void) {
@@ -150,7 +153,7 @@ extern "C" {
     void retro_set_audio_sample(retro_audio_sample_t cb) {
         audio_cb = cb;
         if (audioController) {
-            dynamic_cast<Controller::AudioControllerLibretro&>(*audioController).setAudioCallback(cb);
+            audioController->setAudioCallback(cb);
         }
     }
 
@@ -169,12 +172,21 @@ extern "C" {
     void retro_set_video_refresh(retro_video_refresh_t cb) {
         video_cb = cb;
         if (displayController) {
-            dynamic_cast<Controller::DisplayControllerLibretro&>(*displayController).setVideoCallback(cb);
+            displayController->setVideoCallback(cb);
         }
     }
 
     void retro_reset(void) {
-        // TODO: Reset
+        emulator->reset(true);
+        // All buttons are released by the reset, so the ones which are still held have to be pressed again
+        btnAWasPressed = false;
+        btnBWasPressed = false;
+        btnSelectWasPressed = false;
+        btnStartWasPressed = false;
+        btnUpWasPressed = false;
+        btnDownWasPressed = false;
+        btnLeftWasPressed = false;
+        btnRightWasPressed = false;
     }
 
 #define IS_PRESSED(key) input_state_cb(currentControllerPort, currentControllerDevice, 0, key)
@@ -225,8 +237,29 @@ extern "C" {
 
 #undef IS_PRESSED
 
+    void run_frame() {
+        emulator->runFrame();
+        update_inputs();
+    }
+
     void retro_run(void) {
-        executeFrame();
+        // Bit 0 enables video, bit 1 enables audio. Both are disabled for frames which are emulated ahead and which
+        // will be rolled back, so that they are not displayed.
+        int avEnable = 0b11;
+        if (!environ_cb(RETRO_ENVIRONMENT_GET_AUDIO_VIDEO_ENABLE, &avEnable)) {
+            avEnable = 0b11;
+        }
+        bool videoEnabled = avEnable & 0b01;
+        // Hidden frames are not drawn at all
+        emulator->setRenderPolicy(videoEnabled ? RenderPolicy::RENDER_ALWAYS : RenderPolicy::RENDER_NEVER);
+        audioController->setEnabled(avEnable & 0b10);
+        if (videoEnabled) {
+            executeFrame();
+        } else {
+            // Hidden frames must not be throttled, they are emulated in addition to the displayed ones
+            run_frame();
+            displayController->keepFrame();
+        }
     }
 
     void fb_loadSave(const FunkyBoy::fs::path &savePath) {
@@ -278,6 +311,11 @@ extern "C" {
                 savePath.replace_extension(".sav");
                 emulator->savePath = savePath;
                 fb_loadSave(savePath);
+
+                std::ostringstream stateStream;
+                emulator->saveState(stateStream);
+                saveStateSize = static_cast<size_t>(stateStream.tellp());
+                serializeSize = std::max(saveStateSize, emulator->getSnapshotSize());
                 return true;
             }
             default: {
@@ -289,6 +327,8 @@ extern "C" {
 
     void retro_unload_game(void) {
         fb_writeSave();
+        saveStateSize = 0;
+        serializeSize = 0;
 
         auto ptr = emulator.release();
         delete ptr;
@@ -304,18 +344,39 @@ extern "C" {
         return retro_load_game(info);
     }
 
+    // Snapshots are faster, but can only be restored by the same build with the same game loaded. Save states are
+    // therefore only replaced by snapshots for run-ahead.
+    bool fb_useSnapshots() {
+        int context = RETRO_SAVESTATE_CONTEXT_NORMAL;
+        if (!environ_cb(RETRO_ENVIRONMENT_GET_SAVESTATE_CONTEXT, &context)) {
+            return false;
+        }
+        return context == RETRO_SAVESTATE_CONTEXT_RUNAHEAD_SAME_INSTANCE
+            || context == RETRO_SAVESTATE_CONTEXT_RUNAHEAD_SAME_BINARY;
+    }
+
+    // Without a loaded game, there is nothing to serialize
     size_t retro_serialize_size(void) {
-        return FB_SAVE_STATE_MAX_BUFFER_SIZE;
+        return serializeSize;
     }
 
     bool retro_serialize(void *data_, size_t size) {
-        if (size < FB_SAVE_STATE_MAX_BUFFER_SIZE) {
+        if (serializeSize == 0 || size < serializeSize) {
             return false;
         }
         try {
-            FunkyBoy::Util::membuf outBuf(reinterpret_cast<char *>(data_), FB_SAVE_STATE_MAX_BUFFER_SIZE, false);
-            std::ostream outStream(&outBuf);
-            emulator->saveState(outStream);
+            auto data = reinterpret_cast<u8 *>(data_);
+            size_t usedSize;
+            if (fb_useSnapshots()) {
+                usedSize = emulator->getSnapshotSize();
+                emulator->saveSnapshot(data, usedSize);
+            } else {
+                usedSize = saveStateSize;
+                FunkyBoy::Util::membuf outBuf(reinterpret_cast<char *>(data), saveStateSize, false);
+                std::ostream outStream(&outBuf);
+                emulator->saveState(outStream);
+            }
+            std::memset(data + usedSize, 0, size - usedSize);
             return true;
         } catch (const std::exception &exception) {
             log_cb(retro_log_level::RETRO_LOG_ERROR, "Saving state failed: %s\n", exception.what());
@@ -327,11 +388,15 @@ extern "C" {
     }
 
     bool retro_unserialize(const void *data_, size_t size) {
-        if (size < FB_SAVE_STATE_MAX_BUFFER_SIZE) {
+        if (serializeSize == 0 || size < serializeSize) {
             return false;
         }
         try {
-            FunkyBoy::Util::membuf inBuf(reinterpret_cast<char *>(const_cast<void *>(data_)), FB_SAVE_STATE_MAX_BUFFER_SIZE, true);
+            if (fb_useSnapshots()) {
+                emulator->loadSnapshot(reinterpret_cast<const u8 *>(data_), emulator->getSnapshotSize());
+                return true;
+            }
+            FunkyBoy::Util::membuf inBuf(reinterpret_cast<char *>(const_cast<void *>(data_)), saveStateSize, true);
             std::istream inStream(&inBuf);
             emulator->loadState(inStream);
             return true;
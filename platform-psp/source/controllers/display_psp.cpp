@@ -17,7 +17,7 @@
 #include "display_psp.h"
 
 #include <pspdisplay.h>
-#include <palette/dmg_palette.h>
+#include <cstring>
 
 using namespace FunkyBoyPSP::Controller;
 
@@ -27,16 +27,10 @@ DisplayController::DisplayController()
 {
 }
 
-void DisplayController::drawScanLine(FunkyBoy::u8 y, FunkyBoy::u8 *buffer) {
-    uint32_t pixel;
-    uint_fast8_t x;
-    for (x = 0 ; x < FB_GB_DISPLAY_WIDTH ; x++) {
-        auto &color = FunkyBoy::Palette::ARGB8888::DMG[*(buffer + x)];
-        pixel = (255u << 24u) | (color[0] << 16) | (color[1] << 8) | color[2];
-        frameBuffer[((y + offsetY) * 512) + x + offsetX] = pixel;
+void DisplayController::drawScreen(const FunkyBoy::FrameBuffer &emulatorFrameBuffer) {
+    auto pixels = static_cast<const uint32_t *>(emulatorFrameBuffer.getPixels());
+    for (uint_fast8_t y = 0 ; y < FB_GB_DISPLAY_HEIGHT ; y++) {
+        std::memcpy(frameBuffer + ((y + offsetY) * 512) + offsetX, pixels + (y * FB_GB_DISPLAY_WIDTH), FB_GB_DISPLAY_WIDTH * sizeof(uint32_t));
     }
-}
-
-void DisplayController::drawScreen() {
     sceDisplayWaitVblank();
 }
\ No newline at end of file
@@ -29,8 +29,8 @@ namespace FunkyBoyPSP::Controller {
 
         uint32_t *frameBuffer{};
 
-        void drawScanLine(FunkyBoy::u8 y, FunkyBoy::u8 *buffer) override;
-        void drawScreen() override;
+        // Expects the frame buffer to be in PIXEL_FORMAT_ARGB8888
+        void drawScreen(const FunkyBoy::FrameBuffer &frameBuffer) override;
     };
 
 }
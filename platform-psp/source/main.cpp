@@ -112,7 +112,7 @@ int main() {
 
 #ifdef FB_PSP_USE_FRAME_EXECUTOR
     FunkyBoy::Util::FrameExecutor executeFrame([&emulator]() {
-        while ((emulator.doTick() & FB_RET_NEW_FRAME) == 0);
+        emulator.runFrame();
     }, FB_TARGET_FPS);
 #endif
 
@@ -120,7 +120,7 @@ int main() {
 #ifdef FB_PSP_USE_FRAME_EXECUTOR
         executeFrame();
 #else
-        while ((emulator.doTick() & FB_RET_NEW_FRAME) == 0);
+        emulator.runFrame();
 #endif
 
         Input::poll();
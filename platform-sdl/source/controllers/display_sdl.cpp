@@ -16,32 +16,18 @@
 
 #include "display_sdl.h"
 #include <util/typedefs.h>
-#include <palette/dmg_palette.h>
 
 using namespace FunkyBoy::Controller;
 
 DisplayControllerSDL::DisplayControllerSDL(SDL_Renderer *renderer, SDL_Texture *frameBuffer)
     : renderer(renderer)
     , frameBuffer(frameBuffer)
-    , pixels(new uint32_t[FB_GB_DISPLAY_WIDTH * FB_GB_DISPLAY_HEIGHT])
 {
 }
 
-DisplayControllerSDL::~DisplayControllerSDL() {
-    delete[] pixels;
-}
-
-void DisplayControllerSDL::drawScanLine(FunkyBoy::u8 y, FunkyBoy::u8 *buffer) {
-    uint32_t pixel;
-    for (u8 x = 0 ; x < FB_GB_DISPLAY_WIDTH ; x++) {
-        auto &color = Palette::ARGB8888::DMG[*(buffer + x)];
-        pixel = (255u << 24u) | (color[0] << 16) | (color[1] << 8) | color[2];
-        pixels[(y * FB_GB_DISPLAY_WIDTH) + x] = pixel;
-    }
-}
-
-void DisplayControllerSDL::drawScreen() {
-    SDL_UpdateTexture(frameBuffer, nullptr, pixels, FB_GB_DISPLAY_WIDTH * sizeof(uint32_t));
+void DisplayControllerSDL::drawScreen(const FunkyBoy::FrameBuffer &emulatorFrameBuffer) {
+    // The texture is created as SDL_PIXELFORMAT_ARGB8888, which is the default format of the emulator
+    SDL_UpdateTexture(frameBuffer, nullptr, emulatorFrameBuffer.getPixels(), static_cast<int>(emulatorFrameBuffer.getPitch()));
     SDL_RenderClear(renderer);
     SDL_RenderCopy(renderer, frameBuffer, nullptr, nullptr);
     SDL_RenderPresent(renderer);
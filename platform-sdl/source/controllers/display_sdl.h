@@ -26,13 +26,10 @@ namespace FunkyBoy::Controller {
     private:
         SDL_Renderer *renderer;
         SDL_Texture *frameBuffer;
-        uint32_t *pixels;
     public:
         explicit DisplayControllerSDL(SDL_Renderer *renderer, SDL_Texture *frameBuffer);
-        ~DisplayControllerSDL() override;
 
-        void drawScanLine(u8 y, u8 *buffer) override;
-        void drawScreen() override;
+        void drawScreen(const FrameBuffer &frameBuffer) override;
     };
 
 }
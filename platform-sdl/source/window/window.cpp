@@ -33,6 +33,10 @@ using namespace FunkyBoy::SDL;
 #define FB_CMD_HELP "help"
 #define FB_CMD_FULL_SCREEN "full-screen"
 #define FB_CMD_AUTO_RESUME "auto-resume"
+#define FB_CMD_REWIND_BUFFER "rewind-buffer"
+
+// Rewinding goes back by this many frames per displayed frame
+#define FB_REWIND_FRAME_INTERVAL 2
 
 Window::Window(FunkyBoy::GameBoyType gbType)
     : gbType(gbType)
@@ -42,6 +46,7 @@ Window::Window(FunkyBoy::GameBoyType gbType)
     , frameBuffer(nullptr)
     , keyboardState(SDL_GetKeyboardState(nullptr))
     , fullscreenRequestedPreviously(false)
+    , rewinding(false)
     , autoResume(false)
     , btnAWasPressed(false)
     , btnBWasPressed(false)
@@ -51,6 +56,8 @@ Window::Window(FunkyBoy::GameBoyType gbType)
     , btnDownWasPressed(false)
     , btnLeftWasPressed(false)
     , btnRightWasPressed(false)
+    , emulationTime(0)
+    , emulatedFrames(0)
 {
 }
 
@@ -73,6 +80,7 @@ bool Window::init(int argc, char **argv, size_t width, size_t height) {
             ("t," FB_CMD_TEST, "Test whether the application can start correctly")
             ("f," FB_CMD_FULL_SCREEN, "Launch emulator in full screen mode")
             ("a," FB_CMD_AUTO_RESUME, "Automatically saves the game state and resumes the next time when emulator is opened again using this flag")
+            ("r," FB_CMD_REWIND_BUFFER, "Size of the buffer for rewinding in MiB, 0 disables rewinding", cxxopts::value<unsigned int>()->default_value("16"))
             ("h," FB_CMD_HELP, "Print usage")
             ;
     options.custom_help("[OPTION...] [<ROM PATH>]");
@@ -159,6 +167,12 @@ bool Window::init(int argc, char **argv, size_t width, size_t height) {
             autoResume = true;
         }
 
+        auto rewindBufferSize = result[FB_CMD_REWIND_BUFFER].as<unsigned int>();
+        if (rewindBufferSize > 0) {
+            emulator.enableRewind(static_cast<size_t>(rewindBufferSize) * 1024 * 1024, FB_REWIND_FRAME_INTERVAL);
+            printf("Rewinding is enabled with a buffer of %u MiB, hold Backspace to rewind\n", rewindBufferSize);
+        }
+
         char romTitleSafe[FB_ROM_HEADER_TITLE_BYTES + 1]{};
         std::memcpy(romTitleSafe, reinterpret_cast<const char*>(emulator.getROMHeader()->title), FB_ROM_HEADER_TITLE_BYTES);
         std::string title = romTitleSafe;
@@ -223,6 +237,28 @@ void Window::loadState() {
     }
 }
 
+void Window::printRewindStatus() {
+    auto rewindBuffer = emulator.getRewindBuffer();
+    if (rewindBuffer == nullptr) {
+        return;
+    }
+    double frameTime = 0;
+    if (emulatedFrames > 0) {
+        frameTime = 1000.0 * static_cast<double>(emulationTime) / static_cast<double>(SDL_GetPerformanceFrequency()) / emulatedFrames;
+    }
+    printf(
+            "Rewind buffer holds %.1f s in %zu snapshots, taking up %.2f of %.2f MiB. Emulating a frame took %.2f ms of %.2f ms.\n",
+            static_cast<double>(rewindBuffer->getSnapshotCount() * FB_REWIND_FRAME_INTERVAL) / FB_TARGET_FPS,
+            rewindBuffer->getSnapshotCount(),
+            static_cast<double>(rewindBuffer->getUsedBytes()) / (1024 * 1024),
+            static_cast<double>(rewindBuffer->getCapacity()) / (1024 * 1024),
+            frameTime,
+            1000.0 / FB_TARGET_FPS
+    );
+    emulationTime = 0;
+    emulatedFrames = 0;
+}
+
 void Window::updateInputs() {
     // Poll keyboard inputs once per frame
     while(SDL_PollEvent(&sdlEvents)) {
@@ -276,10 +312,20 @@ void Window::updateInputs() {
 }
 
 void Window::doFrame() {
-    ret_code result;
-    do {
-        result = emulator.doTick();
-    } while ((result & FB_RET_NEW_FRAME) == 0);
+    // Every frame displayed while rewinding restores the newest snapshot, and is then emulated to be displayed
+    bool rewindRequested = keyboardState[SDL_SCANCODE_BACKSPACE];
+    if (rewindRequested && !rewinding) {
+        printRewindStatus();
+    }
+    rewinding = rewindRequested;
+    if (rewinding) {
+        emulator.rewind();
+    }
+
+    Uint64 startTime = SDL_GetPerformanceCounter();
+    emulator.runFrame();
+    emulationTime += SDL_GetPerformanceCounter() - startTime;
+    emulatedFrames++;
 
     updateInputs();
 
@@ -40,6 +40,7 @@ namespace FunkyBoy::SDL {
         bool fullscreenRequestedPreviously;
         bool saveStateRequestedPreviously;
         bool loadStateRequestedPreviously;
+        bool rewinding;
         bool autoResume;
 
         Emulator emulator;
@@ -55,11 +56,17 @@ namespace FunkyBoy::SDL {
         bool btnLeftWasPressed;
         bool btnRightWasPressed;
 
+        // Time spent emulating frames since the last status report, in units of SDL_GetPerformanceCounter
+        Uint64 emulationTime;
+        u32 emulatedFrames;
+
         void updateInputs();
 
         void saveState();
         void loadState();
 
+        void printRewindStatus();
+
         void loadSave();
         void writeSave();
     public:
@@ -17,14 +17,18 @@
 #include "perf_mode.h"
 
 #include <emulator/emulator.h>
+#include <chrono>
+#include <iostream>
 
 using namespace FunkyBoyTests;
 
 int Perf::runPerfMode(const std::string &path, size_t cycles) {
     FunkyBoy::Emulator emulator(FunkyBoy::GameBoyType::GameBoyDMG);
     emulator.loadGame(path);
-    for (size_t i = 0 ; i < cycles ; i++) {
-        emulator.doTick();
-    }
+    auto start = std::chrono::steady_clock::now();
+    emulator.runCycles(cycles);
+    auto end = std::chrono::steady_clock::now();
+    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+    std::cout << "Ran " << emulator.getMachineCycles() << " machine cycles in " << ms << " ms" << std::endl;
     return 0;
 }
\ No newline at end of file
@@ -17,9 +17,11 @@
 #include <acacia.h>
 
 #include <emulator/emulator.h>
+#include <exception/read_exception.h>
 #include <memory/memory.h>
 #include <util/ramsizes.h>
 #include <cstring>
+#include <vector>
 #include "../controllers/serial_test.h"
 #include "../util/rom_commons.h"
 #include <util/membuf.h>
@@ -33,19 +35,23 @@ TEST_SUITE(saveStates) {
         }
     }
 
-    TEST(testBasicSaveState) {
-        auto serial = std::make_shared<FunkyBoy::Controller::SerialControllerTest>();
-        FunkyBoy::Emulator emulator1(TEST_GB_TYPE);
-        emulator1.setControllers(FunkyBoy::Controller::Controllers().withSerial(serial));
-        FunkyBoy::fs::path romPath =
-                FunkyBoy::fs::path("..") / "gb-test-roms" / "cpu_instrs" / "individual" / "01-special.gb";
-        auto status = emulator1.loadGame(romPath);
+    const FunkyBoy::fs::path specialROMPath =
+            FunkyBoy::fs::path("..") / "gb-test-roms" / "cpu_instrs" / "individual" / "01-special.gb";
+
+    void loadSpecialROM(FunkyBoy::Emulator &emulator,
+                        const std::shared_ptr<FunkyBoy::Controller::SerialControllerTest> &serial) {
+        emulator.setControllers(FunkyBoy::Controller::Controllers().withSerial(serial));
+        auto status = emulator.loadGame(specialROMPath);
         if (status != FunkyBoy::CartridgeStatus::Loaded) {
             testFailure("Loading ROM failed");
         }
-        unsigned int i = 0;
-        for (; i < 1110000 ; i++) {
-            if (!emulator1.doTick()) {
+    }
+
+    // Runs the ROM to somewhere in the middle of the test
+    void runSpecialROMHalfway(FunkyBoy::Emulator &emulator,
+                              const std::shared_ptr<FunkyBoy::Controller::SerialControllerTest> &serial) {
+        for (unsigned int i = 0 ; i < 1110000 ; i++) {
+            if (!emulator.doTick()) {
                 testFailure("Emulation tick failed");
             }
             if (std::strcmp("Passed", serial->lastWord) == 0) {
@@ -54,6 +60,34 @@ TEST_SUITE(saveStates) {
                 testFailure("ROM test failed too early");
             }
         }
+    }
+
+    void runSpecialROMToCompletion(FunkyBoy::Emulator &emulator,
+                                   const std::shared_ptr<FunkyBoy::Controller::SerialControllerTest> &serial) {
+        for (unsigned int i = 0 ; i < 2680000 ; i++) {
+            if (!emulator.doTick()) {
+                testFailure("Emulation tick failed");
+            }
+            if (std::strcmp("Passed", serial->lastWord) == 0) {
+                std::cout << std::endl;
+                break;
+            } else if (std::strcmp("Failed", serial->lastWord) == 0) {
+                testFailure("Test has failed");
+                break;
+            }
+        }
+
+        // Blargg's test ROMs will print "Passed" if the tests have passed and "Failed" otherwise
+        // Mooneye ROMs will output some magic number sequences depending of the success
+        assertStandardOutputHasNot("Failed");
+        assertStandardOutputHas("Passed");
+    }
+
+    TEST(testBasicSaveState) {
+        auto serial = std::make_shared<FunkyBoy::Controller::SerialControllerTest>();
+        FunkyBoy::Emulator emulator1(TEST_GB_TYPE);
+        loadSpecialROM(emulator1, serial);
+        runSpecialROMHalfway(emulator1, serial);
 
         FunkyBoy::u8 saveState[FB_SAVE_STATE_MAX_BUFFER_SIZE]{};
         FunkyBoy::Util::membuf outBuf(reinterpret_cast<char *>(saveState), sizeof(saveState), false);
@@ -64,15 +98,13 @@ TEST_SUITE(saveStates) {
         FunkyBoy::Util::membuf inBuf(reinterpret_cast<char *>(saveState), sizeof(saveState), true);
         std::istream inStream(&inBuf);
         FunkyBoy::Emulator emulator2(TEST_GB_TYPE);
-        emulator2.setControllers(FunkyBoy::Controller::Controllers().withSerial(serial));
-        status = emulator2.loadGame(romPath);
-        if (status != FunkyBoy::CartridgeStatus::Loaded) {
-            testFailure("Loading ROM in second emulator failed");
-        }
+        loadSpecialROM(emulator2, serial);
         emulator2.loadState(inStream);
 
         assertEquals(emulator1.memory.ramSizeInBytes, emulator2.memory.ramSizeInBytes);
         assertArrayEquals(emulator1.memory.cram, emulator2.memory.cram, emulator1.memory.ramSizeInBytes);
+        // Register F might not have been computed yet in the first emulator if lazy flags are enabled
+        emulator1.cpu.instrContext.materializeFlags();
         assertEquals(emulator1.cpu.instrContext.instr, emulator2.cpu.instrContext.instr);
         assertEquals(emulator1.cpu.instrContext.cbInstr, emulator2.cpu.instrContext.cbInstr);
         assertEquals(emulator1.cpu.instrContext.haltBugRequested, emulator2.cpu.instrContext.haltBugRequested);
@@ -91,28 +123,109 @@ TEST_SUITE(saveStates) {
         assertEquals(*emulator1.cpu.instrContext.regF, *emulator2.cpu.instrContext.regF);
 
         // Continue executing with second emulator
-        for (; i < 2680000 ; i++) {
-            if (!emulator2.doTick()) {
+        runSpecialROMToCompletion(emulator2, serial);
+    }
+
+    TEST(testSnapshot) {
+        auto serial = std::make_shared<FunkyBoy::Controller::SerialControllerTest>();
+        FunkyBoy::Emulator emulator1(TEST_GB_TYPE);
+        loadSpecialROM(emulator1, serial);
+        runSpecialROMHalfway(emulator1, serial);
+
+        std::vector<FunkyBoy::u8> snapshot(emulator1.getSnapshotSize());
+        emulator1.saveSnapshot(snapshot.data(), snapshot.size());
+
+        FunkyBoy::Emulator emulator2(TEST_GB_TYPE);
+        loadSpecialROM(emulator2, serial);
+        assertEquals(snapshot.size(), emulator2.getSnapshotSize());
+        emulator2.loadSnapshot(snapshot.data(), snapshot.size());
+
+        // Taking a snapshot of the restored state has to result in the same bytes
+        std::vector<FunkyBoy::u8> restoredSnapshot(emulator2.getSnapshotSize());
+        emulator2.saveSnapshot(restoredSnapshot.data(), restoredSnapshot.size());
+        assertEquals(0, std::memcmp(snapshot.data(), restoredSnapshot.data(), snapshot.size()));
+
+        // Continue executing with second emulator
+        runSpecialROMToCompletion(emulator2, serial);
+    }
+
+    TEST(testRewind) {
+        FunkyBoy::Emulator emulator(TEST_GB_TYPE);
+        auto status = emulator.loadGame(specialROMPath);
+        if (status != FunkyBoy::CartridgeStatus::Loaded) {
+            testFailure("Loading ROM failed");
+        }
+        emulator.enableRewind(1024 * 1024, 1);
+
+        // Snapshots for rewinding are taken at the end of every frame
+        std::vector<std::vector<FunkyBoy::u8>> snapshots;
+        while (snapshots.size() < 100) {
+            FunkyBoy::ret_code result = emulator.doTick();
+            if (!result) {
                 testFailure("Emulation tick failed");
             }
-            if (std::strcmp("Passed", serial->lastWord) == 0) {
-                std::cout << std::endl;
-                break;
-            } else if (std::strcmp("Failed", serial->lastWord) == 0) {
-                testFailure("Test has failed");
-                break;
+            if (result & FB_RET_NEW_FRAME) {
+                snapshots.emplace_back(emulator.getSnapshotSize());
+                emulator.saveSnapshot(snapshots.back().data(), snapshots.back().size());
             }
         }
+        assertEquals(snapshots.size(), emulator.getRewindBuffer()->getSnapshotCount());
 
-        // Blargg's test ROMs will print "Passed" if the tests have passed and "Failed" otherwise
-        // Mooneye ROMs will output some magic number sequences depending of the success
-        assertStandardOutputHasNot("Failed");
-        assertStandardOutputHas("Passed");
+        std::vector<FunkyBoy::u8> restoredSnapshot(emulator.getSnapshotSize());
+        while (!snapshots.empty()) {
+            assertTrue(emulator.rewind());
+            emulator.saveSnapshot(restoredSnapshot.data(), restoredSnapshot.size());
+            assertEquals(0, std::memcmp(snapshots.back().data(), restoredSnapshot.data(), restoredSnapshot.size()));
+            snapshots.pop_back();
+        }
+        assertFalse(emulator.rewind());
     }
 
-    void testMBCSaveStateSize(const char *romTitle, FunkyBoy::u8 cartridgeType, FunkyBoy::RAMSize ramSize) {
-        FunkyBoy::Emulator emulator(FunkyBoy::GameBoyDMG);
+    TEST(testClone) {
+        auto serial = std::make_shared<FunkyBoy::Controller::SerialControllerTest>();
+        FunkyBoy::Emulator emulator(TEST_GB_TYPE);
+        loadSpecialROM(emulator, serial);
+        runSpecialROMHalfway(emulator, serial);
+
+        // The serial controller has to be passed on explicitly
+        auto clone = emulator.clone(FunkyBoy::Controller::Controllers().withSerial(serial));
+        assertTrue(emulator.getROMImage() == clone->getROMImage());
 
+        std::vector<FunkyBoy::u8> snapshot(emulator.getSnapshotSize());
+        emulator.saveSnapshot(snapshot.data(), snapshot.size());
+        std::vector<FunkyBoy::u8> clonedSnapshot(clone->getSnapshotSize());
+        clone->saveSnapshot(clonedSnapshot.data(), clonedSnapshot.size());
+        assertEquals(snapshot.size(), clonedSnapshot.size());
+        assertEquals(0, std::memcmp(snapshot.data(), clonedSnapshot.data(), snapshot.size()));
+
+        // Continue executing with the clone
+        runSpecialROMToCompletion(*clone, serial);
+    }
+
+    TEST(testReset) {
+        auto serial = std::make_shared<FunkyBoy::Controller::SerialControllerTest>();
+        FunkyBoy::Emulator emulator(TEST_GB_TYPE);
+        loadSpecialROM(emulator, serial);
+        runSpecialROMHalfway(emulator, serial);
+
+        emulator.reset(false);
+
+        // The reset emulator has to be at the same state as one which has just loaded the game
+        FunkyBoy::Emulator freshEmulator(TEST_GB_TYPE);
+        freshEmulator.loadGame(emulator.getROMImage());
+        std::vector<FunkyBoy::u8> snapshot(emulator.getSnapshotSize());
+        emulator.saveSnapshot(snapshot.data(), snapshot.size());
+        std::vector<FunkyBoy::u8> freshSnapshot(freshEmulator.getSnapshotSize());
+        freshEmulator.saveSnapshot(freshSnapshot.data(), freshSnapshot.size());
+        assertEquals(snapshot.size(), freshSnapshot.size());
+        assertEquals(0, std::memcmp(snapshot.data(), freshSnapshot.data(), snapshot.size()));
+
+        runSpecialROMToCompletion(emulator, serial);
+    }
+
+    // Loads a ROM which only consists of a header
+    void loadHeaderOnlyROM(FunkyBoy::Emulator &emulator, const char *romTitle, FunkyBoy::u8 cartridgeType,
+                           FunkyBoy::RAMSize ramSize) {
         char rom[0x150]{};
         auto *header = reinterpret_cast<FunkyBoy::ROMHeader *>(rom);
 
@@ -125,6 +238,43 @@ TEST_SUITE(saveStates) {
 
         emulator.loadGame(inStream);
         assertEquals(emulator.getCartridgeStatus(), FunkyBoy::CartridgeStatus::Loaded);
+    }
+
+    TEST(testSnapshotOfOtherCartridge) {
+        // The snapshot of the MBC5 with RAM is larger, so that it is not rejected for its size
+        FunkyBoy::Emulator otherEmulator(TEST_GB_TYPE);
+        loadHeaderOnlyROM(otherEmulator, "MBC5 TEST", 0x1B, FunkyBoy::RAMSize::RAM_SIZE_32KB);
+        std::vector<FunkyBoy::u8> otherSnapshot(otherEmulator.getSnapshotSize());
+        otherEmulator.saveSnapshot(otherSnapshot.data(), otherSnapshot.size());
+
+        FunkyBoy::Emulator emulator(TEST_GB_TYPE);
+        loadHeaderOnlyROM(emulator, "MBC1 TEST", 0x01, FunkyBoy::RAMSize::RAM_SIZE_None);
+        for (int i = 0 ; i < 100000 ; i++) {
+            if (!emulator.doTick()) {
+                testFailure("Emulation tick failed");
+            }
+        }
+        assertTrue(otherSnapshot.size() > emulator.getSnapshotSize());
+        std::vector<FunkyBoy::u8> snapshot(emulator.getSnapshotSize());
+        emulator.saveSnapshot(snapshot.data(), snapshot.size());
+
+        bool rejected = false;
+        try {
+            emulator.loadSnapshot(otherSnapshot.data(), otherSnapshot.size());
+        } catch (const FunkyBoy::Exception::ReadException &) {
+            rejected = true;
+        }
+        assertTrue(rejected);
+
+        // A rejected snapshot must not have restored any part of the state
+        std::vector<FunkyBoy::u8> unchangedSnapshot(emulator.getSnapshotSize());
+        emulator.saveSnapshot(unchangedSnapshot.data(), unchangedSnapshot.size());
+        assertEquals(0, std::memcmp(snapshot.data(), unchangedSnapshot.data(), snapshot.size()));
+    }
+
+    void testMBCSaveStateSize(const char *romTitle, FunkyBoy::u8 cartridgeType, FunkyBoy::RAMSize ramSize) {
+        FunkyBoy::Emulator emulator(FunkyBoy::GameBoyDMG);
+        loadHeaderOnlyROM(emulator, romTitle, cartridgeType, ramSize);
 
         emulator.cpu.instrContext.instr = 0x00;
 
@@ -22,11 +22,14 @@
 #include <memory/memory.h>
 #include <memory>
 #include <emulator/emulator.h>
+#include <emulator/scanline_compositor.h>
 #include <controllers/controllers.h>
 #include <cartridge/mbc1.h>
 #include <cartridge/mbc2.h>
 #include <cartridge/mbc3.h>
 #include <util/membuf.h>
+#include <cstring>
+#include <vector>
 
 bool doFullMachineCycle(FunkyBoy::CPU &cpu, FunkyBoy::Memory &memory) {
     cpu.instructionCompleted = false;
@@ -44,6 +47,18 @@ void assertDoFullMachineCycle(FunkyBoy::CPU &cpu, FunkyBoy::Memory &memory) {
     }
 }
 
+class CapturingDisplay : public FunkyBoy::Controller::DisplayController {
+public:
+    FunkyBoy::u8 firstLine[FB_GB_DISPLAY_WIDTH]{};
+    int screens = 0;
+
+    // Expects the frame buffer to be in PIXEL_FORMAT_INDEXED
+    void drawScreen(const FunkyBoy::FrameBuffer &frameBuffer) override {
+        std::memcpy(firstLine, frameBuffer.getPixels(), FB_GB_DISPLAY_WIDTH);
+        screens++;
+    }
+};
+
 inline FunkyBoy::Memory createMemory() {
     FunkyBoy::io_registers io;
     FunkyBoy::PPUMemory ppuMemory;
@@ -71,6 +86,130 @@ TEST_SUITE(unitTests) {
         assertEquals(186, val);
     }
 
+    TEST(testDecodedTiles) {
+        FunkyBoy::io_registers io;
+        FunkyBoy::PPUMemory ppuMemory;
+        FunkyBoy::Memory memory(io, ppuMemory);
+
+        // Second row of tile 1
+        memory.write8BitsTo(0x8012, 0b10100101);
+        memory.write8BitsTo(0x8013, 0b11000011);
+        const FunkyBoy::u8 expected[8] = {3, 2, 1, 0, 0, 1, 2, 3};
+        const FunkyBoy::u8 *row = ppuMemory.getDecodedTileRow(1, 1, false);
+        for (int x = 0 ; x < 8 ; x++) {
+            assertEquals(expected[x], row[x]);
+        }
+        row = ppuMemory.getDecodedTileRow(1, 1, true);
+        for (int x = 0 ; x < 8 ; x++) {
+            assertEquals(expected[7 - x], row[x]);
+        }
+
+        // Writing to the tile again has to invalidate the decoded one
+        memory.write8BitsTo(0x8013, 0xFF);
+        row = ppuMemory.getDecodedTileRow(1, 1, false);
+        assertEquals(3, row[0]);
+        assertEquals(2, row[3]);
+    }
+
+    TEST(testScanlineCompositor) {
+        // More than 16 color indices, so that both the vectorized loop and the remainder are used
+        FunkyBoy::u8 colorIndexes[20];
+        FunkyBoy::u8 shades[20];
+        for (int i = 0 ; i < 20 ; i++) {
+            colorIndexes[i] = i % 4;
+        }
+        // Shades 3, 0, 1, 2 for the color indices 0, 1, 2, 3
+        FunkyBoy::Compositor::applyPalette(shades, colorIndexes, 20, 0b10010011);
+        for (int i = 0 ; i < 20 ; i++) {
+            assertEquals((i + 3) % 4, shades[i]);
+        }
+
+        const FunkyBoy::u8 bgColorIndexes[8] = {0, 1, 0, 2, 0, 3, 0, 0};
+        const FunkyBoy::u8 objColorIndexes[8] = {1, 1, 2, 2, 0, 0, 3, 3};
+        const FunkyBoy::u8 expectedAbove[8] = {0, 0, 1, 1, 0, 1, 2, 2};
+        const FunkyBoy::u8 expectedBehind[8] = {0, 1, 1, 3, 0, 1, 2, 2};
+        std::memcpy(shades, colorIndexes, 8);
+        FunkyBoy::Compositor::drawObjectRow(shades, bgColorIndexes, objColorIndexes, 0b10010011, false);
+        assertEquals(0, std::memcmp(expectedAbove, shades, 8));
+        std::memcpy(shades, colorIndexes, 8);
+        FunkyBoy::Compositor::drawObjectRow(shades, bgColorIndexes, objColorIndexes, 0b10010011, true);
+        assertEquals(0, std::memcmp(expectedBehind, shades, 8));
+    }
+
+    TEST(testPixelFormats) {
+        FunkyBoy::u8 shades[FB_GB_DISPLAY_WIDTH];
+        for (int x = 0 ; x < FB_GB_DISPLAY_WIDTH ; x++) {
+            shades[x] = x % 4;
+        }
+        const FunkyBoy::u8 palette[4][3] = {
+                {255, 255, 255},
+                {255, 0, 0},
+                {0, 255, 0},
+                {0, 0, 255}
+        };
+        FunkyBoy::FrameBuffer frameBuffer;
+        frameBuffer.setPalette(palette);
+
+        frameBuffer.setPixelFormat(FunkyBoy::PIXEL_FORMAT_ARGB8888);
+        frameBuffer.drawLine(1, shades);
+        const FunkyBoy::u32 expectedARGB8888[4] = {0xFFFFFFFF, 0xFFFF0000, 0xFF00FF00, 0xFF0000FF};
+        auto pixels32 = static_cast<const FunkyBoy::u32 *>(frameBuffer.getPixels()) + FB_GB_DISPLAY_WIDTH;
+        for (int x = 0 ; x < FB_GB_DISPLAY_WIDTH ; x++) {
+            assertEquals(expectedARGB8888[x % 4], pixels32[x]);
+        }
+
+        frameBuffer.setPixelFormat(FunkyBoy::PIXEL_FORMAT_RGB565);
+        assertEquals(FB_GB_DISPLAY_WIDTH * 2, frameBuffer.getPitch());
+        frameBuffer.drawLine(1, shades);
+        const FunkyBoy::u16 expectedRGB565[4] = {0xFFFF, 0xF800, 0x07E0, 0x001F};
+        auto pixels16 = static_cast<const FunkyBoy::u16 *>(frameBuffer.getPixels()) + FB_GB_DISPLAY_WIDTH;
+        for (int x = 0 ; x < FB_GB_DISPLAY_WIDTH ; x++) {
+            assertEquals(expectedRGB565[x % 4], pixels16[x]);
+        }
+
+        frameBuffer.setPixelFormat(FunkyBoy::PIXEL_FORMAT_RGBA5551);
+        frameBuffer.drawLine(1, shades);
+        const FunkyBoy::u16 expectedRGBA5551[4] = {0xFFFF, 0xF801, 0x07C1, 0x003F};
+        for (int x = 0 ; x < FB_GB_DISPLAY_WIDTH ; x++) {
+            assertEquals(expectedRGBA5551[x % 4], pixels16[x]);
+        }
+
+        frameBuffer.setPixelFormat(FunkyBoy::PIXEL_FORMAT_INDEXED);
+        frameBuffer.drawLine(1, shades);
+        auto pixels8 = static_cast<const FunkyBoy::u8 *>(frameBuffer.getPixels()) + FB_GB_DISPLAY_WIDTH;
+        assertEquals(0, std::memcmp(shades, pixels8, FB_GB_DISPLAY_WIDTH));
+    }
+
+    TEST(testSpriteLimit) {
+        FunkyBoy::Emulator emulator(TEST_GB_TYPE);
+        auto display = std::make_shared<CapturingDisplay>();
+        emulator.setControllers(FunkyBoy::Controller::Controllers().withDisplay(display));
+        emulator.setPixelFormat(FunkyBoy::PIXEL_FORMAT_INDEXED);
+
+        // LCD and objects on, BG off
+        emulator.ioRegisters.getLCDC() = 0b10000010;
+        emulator.ioRegisters.getOBP0() = 0b11100100;
+        // First row of tile 0 only consists of color index 3
+        emulator.ppuMemory.writeVRAMByte(0, 0xFF);
+        emulator.ppuMemory.writeVRAMByte(1, 0xFF);
+        // 12 objects next to each other on the first line
+        for (int objIdx = 0 ; objIdx < 12 ; objIdx++) {
+            emulator.ppuMemory.writeOAMByte(objIdx * 4, 16);
+            emulator.ppuMemory.writeOAMByte(objIdx * 4 + 1, 8 + objIdx * 8);
+        }
+
+        for (bool limit : {false, true}) {
+            emulator.setSpriteLimitEnabled(limit);
+            for (int clocks = 0 ; clocks < 154 * 456 ; clocks += 4) {
+                emulator.ppu.doClocks(emulator.cpu, 4);
+            }
+            const int expectedWidth = limit ? 80 : 96;
+            for (int x = 0 ; x < FB_GB_DISPLAY_WIDTH ; x++) {
+                assertEquals(x < expectedWidth ? 3 : 0, display->firstLine[x]);
+            }
+        }
+    }
+
     TEST(testReadROMTitle) {
         FunkyBoy::Emulator emulator(TEST_GB_TYPE);
         FunkyBoy::fs::path romPath = FunkyBoy::fs::path("..") / "gb-test-roms" / "cpu_instrs" / "cpu_instrs.gb";
@@ -82,6 +221,125 @@ TEST_SUITE(unitTests) {
         assertEquals("CPU_INSTRS", std::string(reinterpret_cast<const char *>(emulator.getROMHeader()->title)));
     }
 
+    TEST(testShareROMImage) {
+        FunkyBoy::fs::path romPath = FunkyBoy::fs::path("..") / "gb-test-roms" / "cpu_instrs" / "cpu_instrs.gb";
+        FunkyBoy::Emulator emulator1(TEST_GB_TYPE);
+        auto status = emulator1.loadGame(romPath);
+        assertEquals(FunkyBoy::CartridgeStatus::Loaded, status);
+
+        FunkyBoy::Emulator emulator2(TEST_GB_TYPE);
+        status = emulator2.loadGame(emulator1.getROMImage());
+        assertEquals(FunkyBoy::CartridgeStatus::Loaded, status);
+        assertTrue(emulator1.getROMImage() == emulator2.getROMImage());
+
+        // Releasing the ROM of one emulator must not affect the other one
+        size_t romSize;
+        FunkyBoy::u8 *rom = emulator1.releaseROM(&romSize);
+        assertEquals(emulator2.getROMImage()->getSize(), romSize);
+        assertEquals(0, std::memcmp(rom, emulator2.getROMImage()->getData(), romSize));
+        delete[] rom;
+
+        assertEquals("CPU_INSTRS", std::string(reinterpret_cast<const char *>(emulator2.getROMHeader()->title)));
+    }
+
+    TEST(testRenderPolicy) {
+        FunkyBoy::Emulator emulator(TEST_GB_TYPE);
+        FunkyBoy::fs::path romPath = FunkyBoy::fs::path("..") / "gb-test-roms" / "cpu_instrs" / "cpu_instrs.gb";
+        auto status = emulator.loadGame(romPath);
+        assertEquals(FunkyBoy::CartridgeStatus::Loaded, status);
+        auto display = std::make_shared<CapturingDisplay>();
+        emulator.setControllers(FunkyBoy::Controller::Controllers().withDisplay(display));
+
+        emulator.setRenderPolicy(FunkyBoy::RENDER_EVERY_NTH_FRAME, 3);
+        for (int frame = 0 ; frame < 9 ; frame++) {
+            assertEquals(FunkyBoy::STOP_NEW_FRAME, emulator.runFrame());
+        }
+        assertEquals(3, display->screens);
+
+        emulator.setRenderPolicy(FunkyBoy::RENDER_ON_REQUEST);
+        emulator.requestFrame();
+        for (int frame = 0 ; frame < 3 ; frame++) {
+            assertEquals(FunkyBoy::STOP_NEW_FRAME, emulator.runFrame());
+        }
+        assertEquals(4, display->screens);
+
+        emulator.setRenderPolicy(FunkyBoy::RENDER_NEVER);
+        for (int frame = 0 ; frame < 3 ; frame++) {
+            assertEquals(FunkyBoy::STOP_NEW_FRAME, emulator.runFrame());
+        }
+        assertEquals(4, display->screens);
+    }
+
+    TEST(testCloneControllers) {
+        FunkyBoy::Emulator emulator(TEST_GB_TYPE);
+        FunkyBoy::fs::path romPath = FunkyBoy::fs::path("..") / "gb-test-roms" / "cpu_instrs" / "cpu_instrs.gb";
+        auto status = emulator.loadGame(romPath);
+        assertEquals(FunkyBoy::CartridgeStatus::Loaded, status);
+        auto display = std::make_shared<CapturingDisplay>();
+        emulator.setControllers(FunkyBoy::Controller::Controllers().withDisplay(display));
+
+        // Controllers are only shared if they are passed explicitly
+        auto clone = emulator.clone();
+        assertEquals(FunkyBoy::STOP_NEW_FRAME, clone->runFrame());
+        assertEquals(0, display->screens);
+
+        clone = emulator.clone(FunkyBoy::Controller::Controllers().withDisplay(display));
+        assertEquals(FunkyBoy::STOP_NEW_FRAME, clone->runFrame());
+        assertEquals(1, display->screens);
+    }
+
+    TEST(testBreakpoint) {
+        FunkyBoy::Emulator emulator(TEST_GB_TYPE);
+        FunkyBoy::fs::path romPath = FunkyBoy::fs::path("..") / "gb-test-roms" / "cpu_instrs" / "cpu_instrs.gb";
+        auto status = emulator.loadGame(romPath);
+        assertEquals(FunkyBoy::CartridgeStatus::Loaded, status);
+
+        // The entry point consists of a NOP, followed by a jump
+        emulator.setBreakpoint(0x0101, true);
+        auto clone = emulator.clone();
+        assertEquals(FunkyBoy::STOP_BREAKPOINT, emulator.runUntil(FunkyBoy::STOP_BREAKPOINT, 1000));
+        assertEquals(0x0101, emulator.cpu.getFetchedInstructionAddress());
+
+        // Clones stop at the same breakpoints
+        assertEquals(FunkyBoy::STOP_BREAKPOINT, clone->runUntil(FunkyBoy::STOP_BREAKPOINT, 1000));
+        assertEquals(0x0101, clone->cpu.getFetchedInstructionAddress());
+
+        emulator.setBreakpoint(0x0101, false);
+        assertEquals(FunkyBoy::STOP_CYCLE_BUDGET, emulator.runUntil(FunkyBoy::STOP_BREAKPOINT, 1000));
+    }
+
+    TEST(testCycleBudgetWhileHalted) {
+        char rom[0x8000]{};
+        rom[0x100] = static_cast<char>(0xF3); // DI
+        rom[0x101] = static_cast<char>(0x76); // HALT
+        rom[0x102] = static_cast<char>(0x18); // JR -3
+        rom[0x103] = static_cast<char>(0xFD);
+
+        std::vector<FunkyBoy::ExecutionMode> modes{FunkyBoy::ExecutionMode::MACHINE_CYCLE,
+                                                   FunkyBoy::ExecutionMode::INSTRUCTION};
+#ifdef FB_USE_JIT
+        modes.push_back(FunkyBoy::ExecutionMode::JIT);
+#endif
+        for (FunkyBoy::ExecutionMode mode : modes) {
+            FunkyBoy::Emulator emulator(TEST_GB_TYPE);
+            FunkyBoy::Util::membuf inBuf(rom, sizeof(rom), true);
+            std::istream inStream(&inBuf);
+            assertEquals(FunkyBoy::CartridgeStatus::Loaded, emulator.loadGame(inStream));
+            emulator.setExecutionMode(mode);
+
+            // Without any enabled interrupt, the CPU stays halted
+            emulator.runCycles(10);
+            assertEquals(FunkyBoy::CPUState::HALTED, emulator.cpu.getState());
+
+            // Fast-forwarding the halted CPU must not pass the budget
+            for (FunkyBoy::u64 cycles : {1, 3, 1000, 17555, 17557, 100000}) {
+                FunkyBoy::u64 startCycles = emulator.getMachineCycles();
+                assertEquals(FunkyBoy::STOP_CYCLE_BUDGET, emulator.runCycles(cycles));
+                assertEquals(startCycles + cycles, emulator.getMachineCycles());
+            }
+        }
+    }
+
     TEST(testPopPushStackPointer) {
         auto memory = createMemory();
         FunkyBoy::CPU cpu(TEST_GB_TYPE, memory.getIoRegisters());
@@ -390,7 +648,7 @@ TEST_SUITE(unitTests) {
         }
     }
 
-// Test Operands::checkIsZeroContextual and Operands::checkIsCarryContextual using RET
+// Test Operands::checkIsZero and Operands::checkIsCarry using RET
     TEST(testContextualZeroAndCarryCheckOperands) {
         auto memory = createMemory();
         FunkyBoy::CPU cpu(TEST_GB_TYPE, memory.getIoRegisters());
@@ -22,29 +22,54 @@
 #include <emulator/emulator.h>
 #include <cstring>
 
-void testUsingROM(const FunkyBoy::fs::path &romPath, unsigned int expectedTicks, const char *successWord, const char *failureWord) {
-    expectedTicks *= 4;
-    auto serial = std::make_shared<FunkyBoy::Controller::SerialControllerTest>();
-    FunkyBoy::Emulator emulator(TEST_GB_TYPE);
-    emulator.setControllers(FunkyBoy::Controller::Controllers().withSerial(serial));
-    auto status = emulator.loadGame(romPath);
-    if (status != FunkyBoy::CartridgeStatus::Loaded) {
-      std::cout << "Loading test ROM at " << romPath << " failed" << std::endl;
-    }
-    assertEquals(FunkyBoy::CartridgeStatus::Loaded, status);
+namespace {
 
-    for (unsigned int i = 0 ; i < expectedTicks ; i++) {
-        if (!emulator.doTick()) {
-            testFailure("Emulation tick failed");
+    bool runROM(const FunkyBoy::fs::path &romPath, unsigned int expectedCycles, const char *successWord, const char *failureWord, FunkyBoy::ExecutionMode executionMode) {
+        auto serial = std::make_shared<FunkyBoy::Controller::SerialControllerTest>();
+        FunkyBoy::Emulator emulator(TEST_GB_TYPE);
+        emulator.setControllers(FunkyBoy::Controller::Controllers().withSerial(serial));
+        emulator.setExecutionMode(executionMode);
+        auto status = emulator.loadGame(romPath);
+        if (status != FunkyBoy::CartridgeStatus::Loaded) {
+          std::cout << "Loading test ROM at " << romPath << " failed" << std::endl;
         }
-        if (std::strcmp(successWord, serial->lastWord) == 0) {
-            std::cout << std::endl;
-            break;
-        } else if (std::strcmp(failureWord, serial->lastWord) == 0) {
-            testFailure("Test has failed");
-            break;
+        assertEquals(FunkyBoy::CartridgeStatus::Loaded, status);
+
+        // The output only has to be checked after a byte has been sent
+        FunkyBoy::u64 endCycles = emulator.getMachineCycles() + expectedCycles;
+        while (emulator.getMachineCycles() < endCycles) {
+            auto reason = emulator.runUntil(FunkyBoy::STOP_SERIAL_BYTE, endCycles - emulator.getMachineCycles());
+            if (reason == FunkyBoy::STOP_ILLEGAL_OPCODE) {
+                testFailure("Emulation tick failed");
+            }
+            if (std::strcmp(successWord, serial->lastWord) == 0) {
+                std::cout << std::endl;
+                return true;
+            } else if (std::strcmp(failureWord, serial->lastWord) == 0) {
+                testFailure("Test has failed");
+                break;
+            }
         }
+        return false;
+    }
+
+}
+
+void testUsingROM(const FunkyBoy::fs::path &romPath, unsigned int expectedTicks, const char *successWord, const char *failureWord) {
+    expectedTicks *= 4;
+
+    // All execution modes have to yield the same results
+    if (!runROM(romPath, expectedTicks, successWord, failureWord, FunkyBoy::ExecutionMode::MACHINE_CYCLE)) {
+        testFailure("Test did not pass in machine cycle mode");
+    }
+    if (!runROM(romPath, expectedTicks, successWord, failureWord, FunkyBoy::ExecutionMode::INSTRUCTION)) {
+        testFailure("Test did not pass in instruction mode");
+    }
+#ifdef FB_USE_JIT
+    if (!runROM(romPath, expectedTicks, successWord, failureWord, FunkyBoy::ExecutionMode::JIT_VERIFY)) {
+        testFailure("Test did not pass in JIT mode");
     }
+#endif
 
     // Blargg's test ROMs will print "Passed" if the tests have passed and "Failed" otherwise
     // Mooneye ROMs will output some magic number sequences depending of the success